@@ -0,0 +1,297 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <sstream>
+#include "batchProcessor.h"
+#include "dataLoader.h"
+#include "networkGenerator.h"
+#include "centralityAnalysis.h"
+#include "csrGraph.h"
+#include "neighbourhoodFunction.h"
+
+using namespace std;
+
+/**
+ * Bundled dataset, loaded once and shared by every benchmark that doesn't measure loading itself
+ */
+struct BundledDataset {
+    Graph graph = Graph(0);
+    DataRepository dataRepository;
+    airlineTable twoAirlines;
+
+    BundledDataset() {
+        DataLoader(dataRepository, graph).extractFileInfo(AIRTRANSPORT_DATASET_DIR);
+        twoAirlines = {*dataRepository.findAirline("TAP"), *dataRepository.findAirline("UAL")};
+    }
+
+    static BundledDataset &get() {
+        static BundledDataset dataset;
+        return dataset;
+    }
+
+    int node(const string &code) const {
+        return graph.findAirportNode(code);
+    }
+
+    list<int> cityNodes(const string &city, const string &country) const {
+        list<int> cityNodes;
+        for (uint32_t id: dataRepository.findAirportsInCity(city, country))
+            cityNodes.push_back(node(dataRepository.getAirport(id).getCode()));
+        return cityNodes;
+    }
+};
+
+/**
+ * Synthetic network of the given number of airports, generated once per size with the default generator options
+ */
+static Graph &syntheticGraph(unsigned numAirports) {
+    static unordered_map<unsigned, pair<unique_ptr<Graph>, DataRepository>> networks;
+    auto &network = networks[numAirports];
+    if (!network.first) {
+        network.first = make_unique<Graph>(0);
+        GeneratorOptions options;
+        options.numAirports = numAirports;
+        NetworkGenerator(options).buildInto(network.second, *network.first);
+    }
+    return *network.first;
+}
+
+static void BM_LoadDataset(benchmark::State &state) {
+    for (auto _: state) {
+        Graph graph(0);
+        DataRepository dataRepository;
+        DataLoader(dataRepository, graph).extractFileInfo(AIRTRANSPORT_DATASET_DIR);
+        benchmark::DoNotOptimize(graph.getTotalFlights());
+    }
+}
+BENCHMARK(BM_LoadDataset)->Unit(benchmark::kMillisecond);
+
+static void BM_ShortestPathBfsAnyAirline(benchmark::State &state) {
+    BundledDataset &dataset = BundledDataset::get();
+    list<int> source = {dataset.node("OPO")};
+    int destination = dataset.node("SYD");
+    for (auto _: state) {
+        benchmark::DoNotOptimize(dataset.graph.shortest_path_bfs(source, destination,
+                                                                 dataset.dataRepository.getAirlines()));
+    }
+}
+BENCHMARK(BM_ShortestPathBfsAnyAirline)->Unit(benchmark::kMicrosecond);
+
+static void BM_ShortestPathBfsTwoAirlines(benchmark::State &state) {
+    BundledDataset &dataset = BundledDataset::get();
+    list<int> source = {dataset.node("OPO")};
+    int destination = dataset.node("SFO");
+    for (auto _: state) {
+        benchmark::DoNotOptimize(dataset.graph.shortest_path_bfs(source, destination, dataset.twoAirlines));
+    }
+}
+BENCHMARK(BM_ShortestPathBfsTwoAirlines)->Unit(benchmark::kMicrosecond);
+
+static void BM_GetShortestPathCityToCity(benchmark::State &state) {
+    BundledDataset &dataset = BundledDataset::get();
+    list<int> source = dataset.cityNodes("London", "United Kingdom");
+    list<int> target = dataset.cityNodes("New York", "United States");
+    for (auto _: state) {
+        benchmark::DoNotOptimize(dataset.graph.getShortestPath(source, target, dataset.dataRepository.getAirlines()));
+    }
+}
+BENCHMARK(BM_GetShortestPathCityToCity)->Unit(benchmark::kMicrosecond);
+
+static void BM_NumAirportsInXFlights(benchmark::State &state) {
+    BundledDataset &dataset = BundledDataset::get();
+    const Airport &airport = *dataset.dataRepository.findAirport("OPO");
+    for (auto _: state) {
+        benchmark::DoNotOptimize(dataset.graph.numAirportsInXFlights(airport, state.range(0)));
+    }
+}
+BENCHMARK(BM_NumAirportsInXFlights)->Arg(1)->Arg(3)->Unit(benchmark::kMicrosecond);
+
+static void BM_NumCitiesInXFlights(benchmark::State &state) {
+    BundledDataset &dataset = BundledDataset::get();
+    const Airport &airport = *dataset.dataRepository.findAirport("OPO");
+    for (auto _: state) {
+        benchmark::DoNotOptimize(dataset.graph.numCitiesInXFlights(airport, state.range(0)));
+    }
+}
+BENCHMARK(BM_NumCitiesInXFlights)->Arg(1)->Arg(3)->Unit(benchmark::kMicrosecond);
+
+static void BM_NumCountriesInXFlights(benchmark::State &state) {
+    BundledDataset &dataset = BundledDataset::get();
+    const Airport &airport = *dataset.dataRepository.findAirport("OPO");
+    for (auto _: state) {
+        benchmark::DoNotOptimize(dataset.graph.numCountriesInXFlights(airport, state.range(0)));
+    }
+}
+BENCHMARK(BM_NumCountriesInXFlights)->Arg(1)->Arg(3)->Unit(benchmark::kMicrosecond);
+
+static void BM_CountSCCs(benchmark::State &state) {
+    BundledDataset &dataset = BundledDataset::get();
+    for (auto _: state) benchmark::DoNotOptimize(dataset.graph.countSCCs());
+}
+BENCHMARK(BM_CountSCCs)->Unit(benchmark::kMicrosecond);
+
+static void BM_GetDiameter(benchmark::State &state) {
+    BundledDataset &dataset = BundledDataset::get();
+    for (auto _: state) benchmark::DoNotOptimize(dataset.graph.getDiameter());
+}
+BENCHMARK(BM_GetDiameter)->Unit(benchmark::kMillisecond)->Iterations(1);
+
+static void BM_FindAirportsInLocation(benchmark::State &state) {
+    BundledDataset &dataset = BundledDataset::get();
+    for (auto _: state) {
+        benchmark::DoNotOptimize(dataset.dataRepository.findAirportsInLocation(41.2, -8.6, state.range(0)));
+    }
+}
+BENCHMARK(BM_FindAirportsInLocation)->Arg(50)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+static void BM_FindAirportByCode(benchmark::State &state) {
+    BundledDataset &dataset = BundledDataset::get();
+    vector<string> codes;
+    for (const Airport &airport: dataset.dataRepository.getAirports()) codes.push_back(airport.getCode());
+    for (auto _: state) {
+        for (const string &code: codes) {
+            benchmark::DoNotOptimize(dataset.dataRepository.findAirport(code));
+            benchmark::DoNotOptimize(dataset.graph.findAirportNode(code));
+        }
+    }
+    state.SetItemsProcessed((int64_t) (state.iterations() * codes.size()));
+}
+BENCHMARK(BM_FindAirportByCode)->Unit(benchmark::kMicrosecond);
+
+/**
+ * One search per keystroke while typing an airport name, spelled correctly (0) or with a typo (1)
+ */
+static void BM_AirportSearchKeystrokes(benchmark::State &state) {
+    BundledDataset &dataset = BundledDataset::get();
+    string typed = state.range(0) == 0 ? "charles de gaulle" : "charles de gualle";
+    for (auto _: state) {
+        for (size_t length = 1; length <= typed.size(); length++) {
+            benchmark::DoNotOptimize(dataset.dataRepository.searchAirports(typed.substr(0, length)));
+        }
+    }
+    state.SetItemsProcessed((int64_t) (state.iterations() * typed.size()));
+}
+BENCHMARK(BM_AirportSearchKeystrokes)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+static void BM_Betweenness(benchmark::State &state) {
+    BundledDataset &dataset = BundledDataset::get();
+    for (auto _: state) benchmark::DoNotOptimize(CentralityAnalysis::betweenness(dataset.graph, state.range(0)));
+}
+BENCHMARK(BM_Betweenness)->Arg(0)->Arg(300)->Unit(benchmark::kMillisecond)->Iterations(1);
+
+static void BM_PageRank(benchmark::State &state) {
+    BundledDataset &dataset = BundledDataset::get();
+    for (auto _: state) benchmark::DoNotOptimize(CentralityAnalysis::pageRank(dataset.graph));
+}
+BENCHMARK(BM_PageRank)->Unit(benchmark::kMillisecond);
+
+template<typename Csr>
+static void BM_CsrBfsDistance(benchmark::State &state) {
+    BundledDataset &dataset = BundledDataset::get();
+    Csr csr = Csr::fromGraph(dataset.graph);
+    int source = dataset.node("OPO");
+    for (auto _: state) benchmark::DoNotOptimize(csr.bfsDistance(source));
+    state.counters["edge_bytes"] = (double) (csr.targets.size() * sizeof(typename Csr::node_type) +
+                                             csr.payloads.size() * sizeof(typename Csr::payload_type));
+}
+BENCHMARK_TEMPLATE(BM_CsrBfsDistance, CsrGraph)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_CsrBfsDistance, HopCsrGraph)->Unit(benchmark::kMicrosecond);
+
+static void BM_SyntheticBuildAndTeardown(benchmark::State &state) {
+    GeneratorOptions options;
+    options.numAirports = state.range(0);
+    for (auto _: state) {
+        DataRepository dataRepository;
+        Graph graph(0);
+        NetworkGenerator(options).buildInto(dataRepository, graph);
+        benchmark::DoNotOptimize(graph.getTotalFlights());
+    }
+}
+BENCHMARK(BM_SyntheticBuildAndTeardown)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Batch of 2000 route queries between random airports of the bundled dataset, run with the given number of workers
+ */
+static void BM_BatchProcessor(benchmark::State &state) {
+    BundledDataset &dataset = BundledDataset::get();
+    vector<string> codes;
+    for (const Airport &airport: dataset.dataRepository.getAirports()) codes.push_back(airport.getCode());
+    sort(codes.begin(), codes.end());
+    mt19937 random(1);
+    string queries;
+    for (int i = 0; i < 2000; i++) {
+        queries += "route airport " + codes[random() % codes.size()] + " airport " + codes[random() % codes.size()] + "\n";
+    }
+    QueryEngine engine(dataset.graph, dataset.dataRepository, 0);
+    BatchProcessor processor(engine, OutputFormat::CSV, state.range(0));
+    for (auto _: state) {
+        istringstream in(queries);
+        ostringstream out;
+        benchmark::DoNotOptimize(processor.run(in, out));
+    }
+}
+BENCHMARK(BM_BatchProcessor)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond);
+
+static void BM_SyntheticShortestPathBfs(benchmark::State &state) {
+    Graph &graph = syntheticGraph(state.range(0));
+    airlineTable validAirlines;
+    vector<Airline> airlines = NetworkGenerator(GeneratorOptions()).generateAirlines();
+    for (int i = 0; i < state.range(1); i++) validAirlines.insert(airlines[i]);
+    list<int> source = {graph.getN() / 2};
+    for (auto _: state) benchmark::DoNotOptimize(graph.shortest_path_bfs(source, graph.getN(), validAirlines));
+}
+BENCHMARK(BM_SyntheticShortestPathBfs)->ArgsProduct({{10000, 100000}, {3, 450}})->Unit(benchmark::kMillisecond);
+
+static void BM_SyntheticBfsDistance(benchmark::State &state) {
+    Graph &graph = syntheticGraph(state.range(0));
+    for (auto _: state) benchmark::DoNotOptimize(graph.bfsDistance(1));
+}
+BENCHMARK(BM_SyntheticBfsDistance)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Whole-network BFS from every 10000th airport of a 100000 airport synthetic network, renumbered in the given NodeOrder
+ */
+static void BM_SyntheticBfsDistanceByNodeOrder(benchmark::State &state) {
+    static unordered_map<int, pair<unique_ptr<Graph>, DataRepository>> networks;
+    auto &network = networks[(int) state.range(0)];
+    if (!network.first) {
+        network.first = make_unique<Graph>(0);
+        GeneratorOptions options;
+        options.numAirports = 100000;
+        NetworkGenerator(options).buildInto(network.second, *network.first);
+        network.first->reorderNodes((NodeOrder) state.range(0));
+    }
+    Graph &graph = *network.first;
+    for (auto _: state) {
+        for (int v = 1; v <= graph.getN(); v += 10000) benchmark::DoNotOptimize(graph.bfsDistance(v));
+    }
+}
+BENCHMARK(BM_SyntheticBfsDistanceByNodeOrder)
+        ->Arg((int) NodeOrder::LOAD)->Arg((int) NodeOrder::DEGREE)->Arg((int) NodeOrder::RCM)
+        ->Unit(benchmark::kMillisecond)->Iterations(1);
+
+static void BM_SyntheticCountSCCs(benchmark::State &state) {
+    Graph &graph = syntheticGraph(state.range(0));
+    for (auto _: state) benchmark::DoNotOptimize(graph.countSCCs());
+}
+BENCHMARK(BM_SyntheticCountSCCs)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_SyntheticDiameter(benchmark::State &state) {
+    Graph &graph = syntheticGraph(state.range(0));
+    for (auto _: state) benchmark::DoNotOptimize(graph.getDiameter());
+}
+BENCHMARK(BM_SyntheticDiameter)->Arg(2000)->Unit(benchmark::kMillisecond)->Iterations(1);
+
+static void BM_SyntheticPageRank(benchmark::State &state) {
+    Graph &graph = syntheticGraph(state.range(0));
+    for (auto _: state) benchmark::DoNotOptimize(CentralityAnalysis::pageRank(graph));
+}
+BENCHMARK(BM_SyntheticPageRank)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_SyntheticNeighbourhoodFunction(benchmark::State &state) {
+    Graph &graph = syntheticGraph(state.range(0));
+    for (auto _: state) benchmark::DoNotOptimize(NeighbourhoodFunction::compute(graph).averagePathLength());
+}
+BENCHMARK(BM_SyntheticNeighbourhoodFunction)->Arg(100000)->Unit(benchmark::kMillisecond)->Iterations(1);
+
+BENCHMARK_MAIN();
@@ -1,6 +1,7 @@
 #ifndef AIRLINE_H
 #define AIRLINE_H
 
+#include <memory_resource>
 #include <string>
 #include <unordered_set>
 
@@ -44,6 +45,7 @@ struct AirlineEquals {
     }
 };
 
-typedef std::unordered_set<Airline, AirlineHash, AirlineEquals> airlineTable;
+// Polymorphic allocator, so the graph can keep its edges' tables in its arena; copies use the default heap
+typedef std::pmr::unordered_set<Airline, AirlineHash, AirlineEquals> airlineTable;
 
 #endif
\ No newline at end of file
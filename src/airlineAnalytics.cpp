@@ -0,0 +1,149 @@
+#include "airlineAnalytics.h"
+#include <algorithm>
+#include "resultFormatter.h"
+#include "threadPool.h"
+
+using namespace std;
+
+namespace {
+    typedef pair<const Graph::AirlineEdge *, const Graph::AirlineEdge *> edgeRange;
+
+    // Search state of one worker, reused across the airlines it computes
+    struct AirlineScratch {
+        vector<int> localId; // Position of each graph node in the airline's network, or -1 if not served
+        vector<int> served; // Nodes served by the airline
+        vector<edgeRange> out; // Flights of the airline leaving each served node
+        vector<int> num, low, sccStack, dist, queue;
+        vector<bool> onStack;
+        vector<pair<int, const Graph::AirlineEdge *>> callStack;
+    };
+
+    /**
+     * Computes the metrics of one airline over its view of the airline index, without copying its network
+     * Time Complexity: O(|V| * log(d) + k * (k + f)), where d is the largest number of index entries of a node, k the
+     * number of airports served by the airline and f its number of flights
+     */
+    void computeAirline(const Graph &graph, AirlineScratch &scratch, AirlineMetrics &metrics) {
+        int airline = graph.findAirlineId(metrics.airline.getCode());
+        scratch.served.clear();
+        scratch.out.clear();
+        auto serve = [&scratch](int v) {
+            if (scratch.localId[v] != -1) return;
+            scratch.localId[v] = (int) scratch.served.size();
+            scratch.served.push_back(v);
+            scratch.out.push_back({nullptr, nullptr});
+        };
+        for (int v = 1; v <= graph.getN(); v++) {
+            edgeRange range = graph.airlineEdgesOf(v, airline);
+            if (range.first == range.second) continue;
+            serve(v);
+            scratch.out[scratch.localId[v]] = range;
+            for (auto e = range.first; e != range.second; e++) serve(e->dest);
+        }
+        int k = (int) scratch.served.size();
+        metrics.airports = k;
+
+        // Iterative Tarjan, so large networks can't overflow the call stack
+        scratch.num.assign(k, -1);
+        scratch.low.assign(k, 0);
+        scratch.onStack.assign(k, false);
+        int idx = 0;
+        for (int s = 0; s < k; s++) {
+            if (scratch.num[s] != -1) continue;
+            scratch.num[s] = scratch.low[s] = idx++;
+            scratch.sccStack.push_back(s);
+            scratch.onStack[s] = true;
+            scratch.callStack.push_back({s, scratch.out[s].first});
+            while (!scratch.callStack.empty()) {
+                int v = scratch.callStack.back().first;
+                if (scratch.callStack.back().second != scratch.out[v].second) {
+                    int w = scratch.localId[(scratch.callStack.back().second++)->dest];
+                    if (scratch.num[w] == -1) {
+                        scratch.num[w] = scratch.low[w] = idx++;
+                        scratch.sccStack.push_back(w);
+                        scratch.onStack[w] = true;
+                        scratch.callStack.push_back({w, scratch.out[w].first});
+                    } else if (scratch.onStack[w]) scratch.low[v] = min(scratch.low[v], scratch.num[w]);
+                    continue;
+                }
+                scratch.callStack.pop_back();
+                if (!scratch.callStack.empty()) {
+                    int parent = scratch.callStack.back().first;
+                    scratch.low[parent] = min(scratch.low[parent], scratch.low[v]);
+                }
+                if (scratch.low[v] != scratch.num[v]) continue;
+                unsigned size = 0;
+                int w;
+                do {
+                    w = scratch.sccStack.back();
+                    scratch.sccStack.pop_back();
+                    scratch.onStack[w] = false;
+                    size++;
+                } while (w != v);
+                metrics.sccs++;
+                metrics.largestScc = max(metrics.largestScc, size);
+            }
+        }
+
+        // One BFS from every served airport
+        scratch.dist.resize(k);
+        for (int s = 0; s < k; s++) {
+            fill(scratch.dist.begin(), scratch.dist.end(), -1);
+            scratch.queue.assign(1, s);
+            scratch.dist[s] = 0;
+            for (size_t head = 0; head < scratch.queue.size(); head++) {
+                int u = scratch.queue[head];
+                metrics.diameter = max(metrics.diameter, scratch.dist[u]);
+                for (auto e = scratch.out[u].first; e != scratch.out[u].second; e++) {
+                    int w = scratch.localId[e->dest];
+                    if (scratch.dist[w] != -1) continue;
+                    scratch.dist[w] = scratch.dist[u] + 1;
+                    scratch.queue.push_back(w);
+                }
+            }
+        }
+
+        for (int v: scratch.served) scratch.localId[v] = -1;
+    }
+}
+
+/**
+ * Computes the number of airports served, strongly connected components, size of the largest component and diameter
+ * of the network of every airline in the graph's airline index, spreading the airlines across worker threads
+ * Time Complexity: O(A * |V| * log(d) + sum of k * (k + f)) split across the threads, where A is the number of
+ * airlines, d the largest number of index entries of a node, and k and f the airports and flights of each airline
+ * @param graph - Graph whose airline index is up to date
+ * @param numThreads - Number of worker threads, or 0 for one per hardware thread
+ * @return Metrics of every airline, sorted by airline code, or an empty vector if the airline index is stale
+ */
+vector<AirlineMetrics> AirlineAnalytics::compute(const Graph &graph, unsigned numThreads) {
+    vector<AirlineMetrics> metrics;
+    if (!graph.hasAirlineIndex()) return metrics;
+    metrics.reserve(graph.getNumIndexedAirlines());
+    for (int id = 0; id < graph.getNumIndexedAirlines(); id++) metrics.push_back({graph.getIndexedAirline(id)});
+
+    ThreadPool pool(numThreads);
+    vector<AirlineScratch> scratch(pool.size());
+    for (AirlineScratch &workerScratch: scratch) workerScratch.localId.assign(graph.getN() + 1, -1);
+    pool.parallelFor(metrics.size(), [&](unsigned item, unsigned slot) {
+        computeAirline(graph, scratch[slot], metrics[item]);
+    });
+    return metrics;
+}
+
+/**
+ * Writes the metrics as CSV, with a header line
+ * @param out - Stream to write to
+ * @param metrics - Metrics of each airline
+ */
+void AirlineAnalytics::writeCsv(ostream &out, const vector<AirlineMetrics> &metrics) {
+    string text = "airline,name,airports,sccs,largest_scc,diameter\n";
+    for (const AirlineMetrics &airline: metrics) {
+        ResultFormatter::appendCsvField(text, airline.airline.getCode());
+        text += ',';
+        ResultFormatter::appendCsvField(text, airline.airline.getName());
+        text += ',' + to_string(airline.airports) + ',' + to_string(airline.sccs) + ',' +
+                to_string(airline.largestScc) + ',' + to_string(airline.diameter) + '\n';
+    }
+    out << text;
+}
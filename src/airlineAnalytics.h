@@ -0,0 +1,23 @@
+#ifndef AIRLINEANALYTICS_H
+#define AIRLINEANALYTICS_H
+
+#include <ostream>
+#include <vector>
+#include "graph.h"
+
+struct AirlineMetrics {
+    Airline airline;
+    unsigned airports = 0; // Airports with at least one flight of the airline
+    unsigned sccs = 0; // Strongly connected components of the airline's network
+    unsigned largestScc = 0; // Number of airports in its largest strongly connected component
+    int diameter = 0; // Largest number of flights of the airline needed between two airports connected by it
+};
+
+class AirlineAnalytics {
+public:
+    static std::vector<AirlineMetrics> compute(const Graph &graph, unsigned numThreads = 0);
+
+    static void writeCsv(std::ostream &out, const std::vector<AirlineMetrics> &metrics);
+};
+
+#endif
@@ -0,0 +1,259 @@
+#include "airportSearchIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <unordered_map>
+#include "arena.h"
+#include "instrumentation.h"
+#include "memoryTracker.h"
+
+using namespace std;
+
+unsigned const AirportSearchIndex::MAX_EDITS = 3;
+size_t const AirportSearchIndex::DEFAULT_LIMIT = 10;
+
+/**
+ * Converts text to the form the index compares: ASCII letters in lower case, and every run of characters other than
+ * letters and digits turned into a single space between words (bytes outside ASCII are kept as they are)
+ * Time Complexity: O(n), where n is the length of the text
+ * @param text - Text to normalize
+ * @return Normalized text
+ */
+string AirportSearchIndex::normalize(const string &text) {
+    string normalized;
+    normalized.reserve(text.size());
+    bool separator = false;
+    for (unsigned char c: text) {
+        if (c < 0x80 && !isalnum(c)) {
+            separator = true;
+            continue;
+        }
+        if (separator && !normalized.empty()) normalized += ' ';
+        separator = false;
+        normalized += (char) tolower(c);
+    }
+    return normalized;
+}
+
+/**
+ * Returns how many edits a search allows by default for a text of the given length: none below 4 characters, where
+ * one edit already matches a large part of the index, 1 below 8 characters and 2 from then on
+ * @param length - Length of the normalized text
+ */
+unsigned AirportSearchIndex::defaultMaxEdits(size_t length) {
+    if (length < 4) return 0;
+    if (length < 8) return 1;
+    return 2;
+}
+
+string_view AirportSearchIndex::keyText(const Key &key) const {
+    return {text.data() + key.offset, key.length};
+}
+
+/**
+ * Orders the matches of a search, lower being better: fewer edits first, then an airport code equal to the text, then
+ * matches at the start of a field and then at the start of a later word, then the heavier airports and finally codes
+ * before names before cities. Ties are broken by the position of the airport, that is, by code
+ */
+uint64_t AirportSearchIndex::rank(const Key &key, unsigned edits, size_t searchedLength, uint32_t weight) {
+    uint64_t kind = key.wordStart ? 2 : key.field == SearchField::CODE && edits == 0 && key.length == searchedLength
+                                        ? 0 : 1;
+    return (uint64_t) edits << 60 | kind << 58 | (uint64_t) (numeric_limits<uint32_t>::max() - weight) << 26 |
+           (uint64_t) key.field << 24;
+}
+
+/**
+ * Builds the index over the given airports, replacing its previous contents
+ * Time Complexity: O(k log k), where k is the number of keys (one per airport code, name and city, and per later word
+ * of the names and cities)
+ * @param airportsToIndex - Airports to index, which must outlive the index
+ * @param weight - Gives the weight of each Airport (e.g. its number of flights), heavier airports being ranked first
+ * among otherwise equal matches; every Airport weighs the same if not given
+ */
+void AirportSearchIndex::build(const airportTable &airportsToIndex, const function<unsigned(const Airport &)> &weight) {
+    MemoryScope memoryScope(MemoryCategory::SEARCH_INDEX);
+    clear();
+    airports.reserve(airportsToIndex.size());
+    for (const Airport &airport: airportsToIndex) airports.push_back(&airport);
+    sort(airports.begin(), airports.end(),
+         [](const Airport *a1, const Airport *a2) { return a1->getCode() < a2->getCode(); });
+
+    unordered_map<string, uint32_t> offsets; // Offset in text of each normalized field, so repeated ones are shared
+    weights.reserve(airports.size());
+    for (uint32_t i = 0; i < airports.size(); i++) {
+        const Airport &airport = *airports[i];
+        weights.push_back(weight ? weight(airport) : 0);
+        for (auto [field, value]: {pair<SearchField, const string &>(SearchField::CODE, airport.getCode()),
+                                   pair<SearchField, const string &>(SearchField::NAME, airport.getName()),
+                                   pair<SearchField, const string &>(SearchField::CITY, airport.getCity())}) {
+            string normalized = normalize(value);
+            if (normalized.empty()) continue;
+            auto [it, inserted] = offsets.try_emplace(normalized, (uint32_t) text.size());
+            if (inserted) text += normalized;
+            uint16_t length = (uint16_t) min(normalized.size(), (size_t) numeric_limits<uint16_t>::max());
+            keys.push_back({it->second, i, length, field, false});
+            if (field == SearchField::CODE) continue;
+            for (uint16_t start = 1; start < length; start++) {
+                if (normalized[start - 1] != ' ') continue;
+                keys.push_back({it->second + start, i, (uint16_t) (length - start), field, true});
+            }
+        }
+    }
+
+    sort(keys.begin(), keys.end(), [this](const Key &k1, const Key &k2) {
+        int order = keyText(k1).compare(keyText(k2));
+        if (order != 0) return order < 0;
+        return k1.airport != k2.airport ? k1.airport < k2.airport : k1.field < k2.field;
+    });
+    text.shrink_to_fit();
+    keys.shrink_to_fit();
+}
+
+void AirportSearchIndex::clear() {
+    airports.clear();
+    weights.clear();
+    text.clear();
+    keys.clear();
+}
+
+bool AirportSearchIndex::empty() const {
+    return airports.empty();
+}
+
+size_t AirportSearchIndex::numKeys() const {
+    return keys.size();
+}
+
+/**
+ * Returns the number of heap bytes held by the index
+ */
+size_t AirportSearchIndex::memoryUsage() const {
+    return airports.capacity() * sizeof(const Airport *) + weights.capacity() * sizeof(uint32_t) + text.capacity() +
+           keys.capacity() * sizeof(Key);
+}
+
+/**
+ * Finds the airports whose code, name or city (or a word of them) starts with the given text, allowing up to maxEdits
+ * insertions, deletions or substitutions of characters after the first one, and returns the best ones (see rank).
+ * With no edits allowed the matching keys are found by binary search. Otherwise the keys with the same first character
+ * are walked in order, keeping the rows of the edit distance table between the text and each prefix of the current
+ * key: a key only computes the rows past the prefix it shares with the previous one, and once a row has no entry within
+ * maxEdits, every key starting with that prefix is settled at once, matching with the best distance seen above that
+ * row or not at all. The table lives in the scratch arena, so a search allocates nothing but its result
+ * Time Complexity: O(log m + r) without edits, where m is the number of keys and r the number of matching keys, and
+ * O(log m + t * maxEdits + r) with them, where t is the number of distinct key prefixes within maxEdits of a prefix of
+ * the text, plus O(r log r) to rank the matches in the worst case
+ * @param searched - Text to search for, normalized before the search
+ * @param limit - Max number of airports to return
+ * @param maxEdits - Max number of edits, at most MAX_EDITS and less than the length of the text, or -1 for
+ * defaultMaxEdits
+ * @return vector with the best matching airports, at most one match each, best first
+ */
+vector<AirportMatch> AirportSearchIndex::search(const string &searched, size_t limit, int maxEdits) const {
+    ScopedMeasurement measurement(Operation::AIRPORT_SEARCH);
+    vector<AirportMatch> matches;
+    string normalized = normalize(searched);
+    size_t n = normalized.size();
+    if (n == 0 || limit == 0 || keys.empty()) return matches;
+    unsigned k = maxEdits < 0 ? defaultMaxEdits(n) : min((unsigned) maxEdits, MAX_EDITS);
+    k = min(k, (unsigned) n - 1);
+
+    ScratchScope scratch;
+    pmr::vector<pair<uint64_t, uint32_t>> candidates(scratch.resource()); // (rank, airport)
+    auto addRange = [&](size_t first, size_t last, unsigned edits) {
+        for (size_t i = first; i < last; i++) {
+            measurement.nodeExpanded();
+            candidates.emplace_back(rank(keys[i], edits, n, weights[keys[i].airport]), keys[i].airport);
+        }
+    };
+
+    // Keys starting with the whole text, or with its first character when edits are allowed (typos in the first
+    // character are rare, and allowing them would mean walking every key)
+    string_view fixed = string_view(normalized).substr(0, k == 0 ? n : 1);
+    auto first = lower_bound(keys.begin(), keys.end(), fixed,
+                             [this](const Key &key, string_view value) { return keyText(key) < value; });
+    auto last = partition_point(first, keys.end(),
+                                [&](const Key &key) { return keyText(key).substr(0, fixed.size()) == fixed; });
+    size_t begin = first - keys.begin(), end = last - keys.begin();
+
+    if (k == 0) addRange(begin, end, 0);
+    else {
+        // rows[d * (n + 1) + j]: edits between the first d characters of the key and the first j of the text, capped
+        // at k + 1; best[d]: fewest edits between the text and a prefix of the key of at most d characters
+        size_t maxDepth = n + k; // Deeper prefixes are more than k edits away from the whole text
+        uint8_t cap = (uint8_t) (k + 1);
+        pmr::vector<uint8_t> rows((maxDepth + 1) * (n + 1), 0, scratch.resource());
+        pmr::vector<uint8_t> best(maxDepth + 1, cap, scratch.resource());
+        for (size_t j = 0; j <= n; j++) rows[j] = (uint8_t) min(j, (size_t) cap);
+        best[0] = rows[n];
+
+        string_view previous;
+        size_t computed = 0; // Rows of the table filled for previous
+        size_t i = begin;
+        while (i < end) {
+            string_view key = keyText(keys[i]);
+            size_t depth = 0, shared = min({computed, key.size(), previous.size()});
+            while (depth < shared && key[depth] == previous[depth]) depth++;
+
+            size_t deepest = min(key.size(), maxDepth);
+            bool settled = false; // Whether every key starting with key[0..depth) has the same distance
+            while (depth < deepest && !settled) {
+                depth++;
+                const uint8_t *above = &rows[(depth - 1) * (n + 1)];
+                uint8_t *row = &rows[depth * (n + 1)];
+                // Entries more than k columns away from the diagonal are over k edits, so only the band is computed,
+                // with a capped entry on each side of it for the next row to read
+                size_t first = depth > k ? depth - k : 1, last = min(n, depth + k);
+                row[0] = (uint8_t) min(depth, (size_t) cap);
+                if (first > 1) row[first - 1] = cap;
+                if (last < n) row[last + 1] = cap;
+                uint8_t rowMin = row[0];
+                for (size_t j = first; j <= last; j++) {
+                    uint8_t cost = min({(uint8_t) (above[j] + 1), (uint8_t) (row[j - 1] + 1),
+                                        (uint8_t) (above[j - 1] + (key[depth - 1] != normalized[j - 1]))});
+                    row[j] = min(cost, cap);
+                    rowMin = min(rowMin, row[j]);
+                }
+                best[depth] = last == n ? min(best[depth - 1], row[n]) : best[depth - 1];
+                // Settled once no entry is within k edits, or once the whole text matched exactly
+                settled = rowMin >= cap || best[depth] == 0;
+            }
+            settled = settled || depth == maxDepth;
+            previous = key;
+            computed = depth;
+
+            size_t next = i + 1;
+            if (settled) {
+                // Most prefixes are shared by a handful of keys, so gallop forward before the binary search
+                string_view prefix = key.substr(0, depth);
+                auto sharesPrefix = [&](const Key &other) { return keyText(other).substr(0, depth) == prefix; };
+                size_t shared = i, probe = i + 1; // keys[shared] starts with the prefix, keys[probe] may not
+                for (size_t step = 2; probe < end && sharesPrefix(keys[probe]); step *= 2) {
+                    shared = probe;
+                    probe = shared + step;
+                }
+                next = partition_point(keys.begin() + (long) shared + 1, keys.begin() + (long) min(probe, end),
+                                       sharesPrefix) - keys.begin();
+            }
+            if (best[depth] <= k) addRange(i, next, best[depth]);
+            i = next;
+        }
+    }
+
+    // The best rank of each airport comes first, so an airport seen before in this order is already in matches
+    size_t sorted = min(candidates.size(), 4 * limit);
+    partial_sort(candidates.begin(), candidates.begin() + (long) sorted, candidates.end());
+    for (size_t i = 0; i < candidates.size() && matches.size() < limit; i++) {
+        if (i == sorted) {
+            sort(candidates.begin() + (long) sorted, candidates.end());
+            sorted = candidates.size();
+        }
+        const Airport *airport = airports[candidates[i].second];
+        if (any_of(matches.begin(), matches.end(), [&](const AirportMatch &m) { return m.airport == airport; })) {
+            continue;
+        }
+        matches.push_back({airport, (SearchField) ((candidates[i].first >> 24) & 3),
+                           (unsigned) (candidates[i].first >> 60)});
+    }
+    return matches;
+}
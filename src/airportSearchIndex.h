@@ -0,0 +1,71 @@
+#ifndef AIRPORTSEARCHINDEX_H
+#define AIRPORTSEARCHINDEX_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "airport.h"
+
+enum class SearchField : uint8_t {
+    CODE,
+    NAME,
+    CITY
+};
+
+struct AirportMatch {
+    const Airport *airport;
+    SearchField field; // Field of the Airport that matched
+    unsigned edits; // Edits turning the searched text into the start of the field, or of one of its words
+};
+
+/**
+ * Index of the airport codes, names and cities for autocompletion. Every field is normalized (see normalize) and
+ * stored once in a shared buffer, and a key is kept for the start of the field and of each of its words, all sorted
+ * by their text: a prefix lookup is a binary search, and a fuzzy lookup walks the keys in order as if they were a trie,
+ * reusing the edit distance rows of the prefix shared with the previous key and skipping every key under a prefix
+ * that is already too far from the text.
+ * The index points to the Airports it was built from, so it must be rebuilt if they change
+ */
+class AirportSearchIndex {
+private:
+    struct Key {
+        uint32_t offset; // Start of the key in text
+        uint32_t airport; // Position of the Airport in airports
+        uint16_t length; // Characters from the start of the key to the end of its field
+        SearchField field;
+        bool wordStart; // Whether the key starts at a word other than the first of its field
+    };
+
+    std::vector<const Airport *> airports; // Sorted by code
+    std::vector<uint32_t> weights; // Weight of each Airport in airports, ranking matches that are otherwise equal
+    std::string text; // Normalized fields, each stored once
+    std::vector<Key> keys; // Sorted by their text
+
+    std::string_view keyText(const Key &key) const;
+
+    static uint64_t rank(const Key &key, unsigned edits, size_t searchedLength, uint32_t weight);
+
+public:
+    static const unsigned MAX_EDITS;
+    static const size_t DEFAULT_LIMIT;
+
+    static std::string normalize(const std::string &text);
+
+    static unsigned defaultMaxEdits(size_t length);
+
+    void build(const airportTable &airportsToIndex, const std::function<unsigned(const Airport &)> &weight = nullptr);
+
+    void clear();
+
+    bool empty() const;
+
+    size_t numKeys() const;
+
+    size_t memoryUsage() const;
+
+    std::vector<AirportMatch> search(const std::string &searched, size_t limit = DEFAULT_LIMIT, int maxEdits = -1) const;
+};
+
+#endif
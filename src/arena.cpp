@@ -0,0 +1,74 @@
+#include "arena.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+using namespace std;
+
+size_t const Arena::FIRST_BLOCK_SIZE = 64 * 1024;
+size_t const Arena::MAX_BLOCK_SIZE = 1024 * 1024;
+
+Arena::~Arena() {
+    for (Block &block: blocks) ::operator delete(block.data);
+}
+
+/**
+ * Bumps the current block, moving on to the next block (allocating it if there is none) when it doesn't fit
+ * Time Complexity: O(1) (amortized)
+ */
+void *Arena::do_allocate(size_t bytes, size_t alignment) {
+    while (current < blocks.size()) {
+        uintptr_t base = (uintptr_t) blocks[current].data;
+        size_t start = (base + used + alignment - 1) / alignment * alignment - base;
+        if (start + bytes <= blocks[current].size) {
+            used = start + bytes;
+            return blocks[current].data + start;
+        }
+        current++;
+        used = 0;
+    }
+    size_t size = blocks.empty() ? FIRST_BLOCK_SIZE : min(2 * blocks.back().size, MAX_BLOCK_SIZE);
+    size = max(size, bytes + alignment);
+    blocks.push_back({(char *) ::operator new(size), size});
+    current = blocks.size() - 1;
+    used = 0;
+    return do_allocate(bytes, alignment);
+}
+
+bool Arena::do_is_equal(const pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+Arena::Mark Arena::mark() const {
+    return {current, used};
+}
+
+/**
+ * Frees everything allocated since a mark was taken, keeping the blocks
+ * @param mark - Mark to go back to
+ */
+void Arena::rewind(Mark mark) {
+    current = mark.block;
+    used = mark.used;
+}
+
+/**
+ * Returns the number of bytes held by the arena's blocks
+ */
+size_t Arena::capacity() const {
+    size_t total = 0;
+    for (const Block &block: blocks) total += block.size;
+    return total;
+}
+
+size_t Arena::numBlocks() const {
+    return blocks.size();
+}
+
+/**
+ * Returns the calling thread's scratch arena
+ */
+Arena &Arena::scratch() {
+    thread_local Arena arena;
+    return arena;
+}
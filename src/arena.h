@@ -0,0 +1,82 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+/**
+ * Bump allocator over blocks taken from the heap: deallocating does nothing, and the memory is given back as a whole,
+ * either to the heap when the arena is destroyed or to the arena itself by rewinding it to an earlier mark, which
+ * keeps the blocks for later allocations. Blocks double in size up to MAX_BLOCK_SIZE, so at most one block is left
+ * partly unused. Not thread safe
+ */
+class Arena : public std::pmr::memory_resource {
+private:
+    struct Block {
+        char *data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;
+    size_t current = 0; // Block being allocated from
+    size_t used = 0; // Bytes used of the current block
+
+protected:
+    void *do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void *, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+public:
+    static const size_t FIRST_BLOCK_SIZE;
+    static const size_t MAX_BLOCK_SIZE;
+
+    struct Mark {
+        size_t block;
+        size_t used;
+    };
+
+    Arena() = default;
+
+    ~Arena() override;
+
+    Arena(const Arena &) = delete;
+
+    Arena &operator=(const Arena &) = delete;
+
+    Mark mark() const;
+
+    void rewind(Mark mark);
+
+    size_t capacity() const;
+
+    size_t numBlocks() const;
+
+    static Arena &scratch();
+};
+
+/**
+ * Gives access to the current thread's scratch Arena for the containers a query builds and throws away, rewinding it
+ * when the scope ends. Once the arena has grown to what the searches need, they make no heap allocations.
+ * Containers must not outlive the scope they were allocated in, nor grow while a nested scope is open
+ */
+class ScratchScope {
+private:
+    Arena &arena;
+    Arena::Mark start;
+
+public:
+    ScratchScope() : arena(Arena::scratch()), start(arena.mark()) {}
+
+    ~ScratchScope() { arena.rewind(start); }
+
+    ScratchScope(const ScratchScope &) = delete;
+
+    ScratchScope &operator=(const ScratchScope &) = delete;
+
+    std::pmr::memory_resource *resource() const { return &arena; }
+};
+
+#endif
@@ -0,0 +1,124 @@
+#include "batchProcessor.h"
+#include <map>
+#include <thread>
+#include "instrumentation.h"
+#include "threadPool.h"
+
+using namespace std;
+
+size_t const BatchProcessor::FLUSH_THRESHOLD = 1 << 16;
+size_t const BatchProcessor::QUEUE_CAPACITY = 256;
+unsigned const BatchProcessor::MAX_IN_FLIGHT = 4096;
+
+/**
+ * @param engine - Engine executing the queries
+ * @param format - Format of the results
+ * @param numWorkers - Number of threads executing queries, or 0 for one per hardware thread
+ */
+BatchProcessor::BatchProcessor(QueryEngine &engine, OutputFormat format, unsigned numWorkers)
+        : engine(engine), formatter(format), numWorkers(numWorkers == 0 ? ThreadPool::defaultThreads() : numWorkers) {}
+
+/**
+ * Worker stage: executes the parsed queries and formats their results, until the requests queue is closed
+ * @param requests - Queue to take the queries from
+ * @param responses - Queue to hand the formatted results to
+ */
+void BatchProcessor::work(BoundedQueue<Request> &requests, BoundedQueue<Response> &responses) const {
+    Request request;
+    while (requests.pop(request)) {
+        QueryResult result;
+        if (request.parsed) {
+            ScopedMeasurement measurement(Operation::QUERY_EXECUTE);
+            result = engine.execute(request.query);
+        } else {
+            result.ok = false;
+            result.error = request.error;
+        }
+        Response response;
+        response.sequence = request.sequence;
+        {
+            ScopedMeasurement measurement(Operation::QUERY_FORMAT);
+            formatter.append(response.text, request.lineNumber, request.line, result);
+        }
+        responses.push(std::move(response));
+    }
+}
+
+/**
+ * Reads queries line by line, executes them and writes their results in the order of the queries, as a pipeline: this
+ * thread reads and parses the lines, numWorkers threads execute the queries and format the results, and a writer
+ * thread puts the results back in order and writes them in large blocks. Bounded queues connect the stages, and at
+ * most MAX_IN_FLIGHT queries are read ahead of the last result written, so a slow query doesn't let the results
+ * queued behind it pile up.
+ * Blank lines and lines starting with # are skipped, and lines that aren't valid queries produce an error result
+ * Time Complexity: O(sum of the complexities of the queries), split across the workers
+ * @param in - Stream to read the queries from
+ * @param out - Stream to write the results to
+ * @return Number of queries processed
+ */
+unsigned BatchProcessor::run(istream &in, ostream &out) {
+    BoundedQueue<Request> requests(QUEUE_CAPACITY);
+    BoundedQueue<Response> responses(QUEUE_CAPACITY);
+    mutex writtenMutex;
+    condition_variable writtenChanged;
+    unsigned written = 0; // Number of results written
+
+    vector<thread> workers;
+    for (unsigned i = 0; i < numWorkers; i++) {
+        workers.emplace_back(&BatchProcessor::work, this, ref(requests), ref(responses));
+    }
+    thread writer([&]() {
+        string buffer;
+        buffer.reserve(FLUSH_THRESHOLD * 2);
+        formatter.appendHeader(buffer);
+        map<unsigned, string> ready; // Results completed out of order, by sequence
+        unsigned next = 0;
+        Response response;
+        while (responses.pop(response)) {
+            ready.emplace(response.sequence, std::move(response.text));
+            if (ready.begin()->first != next) continue;
+            for (auto it = ready.begin(); it != ready.end() && it->first == next; it = ready.erase(it), next++) {
+                buffer += it->second;
+                if (buffer.size() >= FLUSH_THRESHOLD) {
+                    out.write(buffer.data(), (streamsize) buffer.size());
+                    buffer.clear();
+                }
+            }
+            {
+                lock_guard<mutex> lock(writtenMutex);
+                written = next;
+            }
+            writtenChanged.notify_one();
+        }
+        out.write(buffer.data(), (streamsize) buffer.size());
+        out.flush();
+    });
+
+    string line;
+    unsigned lineNumber = 0, sequence = 0;
+    while (getline(in, line)) {
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (QueryParser::isBlankOrComment(line)) continue;
+
+        Request request;
+        request.sequence = sequence++;
+        request.lineNumber = lineNumber;
+        {
+            ScopedMeasurement measurement(Operation::QUERY_PARSE);
+            request.parsed = QueryParser::parse(line, request.query, request.error);
+        }
+        request.line = std::move(line);
+        {
+            unique_lock<mutex> lock(writtenMutex);
+            writtenChanged.wait(lock, [&]() { return request.sequence < written + MAX_IN_FLIGHT; });
+        }
+        requests.push(std::move(request));
+    }
+
+    requests.close();
+    for (thread &worker: workers) worker.join();
+    responses.close();
+    writer.join();
+    return sequence;
+}
@@ -0,0 +1,41 @@
+#ifndef BATCHPROCESSOR_H
+#define BATCHPROCESSOR_H
+
+#include <iostream>
+#include <string>
+#include "boundedQueue.h"
+#include "queryEngine.h"
+#include "resultFormatter.h"
+
+class BatchProcessor {
+private:
+    struct Request {
+        unsigned sequence = 0; // Position of the query among the processed ones, from 0
+        unsigned lineNumber = 0;
+        std::string line;
+        Query query;
+        bool parsed = false;
+        std::string error; // Reason the line isn't a valid query, if !parsed
+    };
+
+    struct Response {
+        unsigned sequence = 0;
+        std::string text; // Formatted result
+    };
+
+    QueryEngine &engine;
+    ResultFormatter formatter;
+    unsigned numWorkers;
+    size_t static const FLUSH_THRESHOLD;
+    size_t static const QUEUE_CAPACITY;
+    unsigned static const MAX_IN_FLIGHT;
+
+    void work(BoundedQueue<Request> &requests, BoundedQueue<Response> &responses) const;
+
+public:
+    BatchProcessor(QueryEngine &engine, OutputFormat format, unsigned numWorkers = 1);
+
+    unsigned run(std::istream &in, std::ostream &out);
+};
+
+#endif
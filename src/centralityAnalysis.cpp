@@ -0,0 +1,195 @@
+#include "centralityAnalysis.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include "csrGraph.h"
+#include "resultFormatter.h"
+#include "threadPool.h"
+
+using namespace std;
+
+namespace {
+    // Search state of one worker, allocated once so the searches themselves don't allocate
+    struct BrandesScratch {
+        vector<int> dist, order;
+        vector<double> paths, dependency, centrality;
+    };
+
+}
+
+/**
+ * Computes the betweenness centrality of every airport in the hop graph with Brandes' algorithm: one BFS per source
+ * counts the shortest paths to every node, and walking the nodes back in BFS order accumulates how many of them pass
+ * through each node. Sources are spread across worker threads, each adding into its own accumulator. With numPivots
+ * set, only that many sources (chosen at random) are searched and the result is scaled, giving an estimate.
+ * Time Complexity: O(s * (|V| + |E|)) split across the threads, where s is the number of sources searched
+ * @param graph - Graph to analyse
+ * @param numPivots - Number of sampled sources, or 0 (or at least |V|) to search from every airport
+ * @param numThreads - Number of worker threads, or 0 for one per hardware thread
+ * @param seed - Seed choosing the sampled sources
+ * @return Betweenness of each node (index 0 is unused), counting ordered pairs of airports
+ */
+vector<double> CentralityAnalysis::betweenness(const Graph &graph, unsigned numPivots, unsigned numThreads,
+                                                unsigned seed) {
+    int n = graph.getN();
+    CsrGraph csr = CsrGraph::fromGraph(graph);
+    const vector<int> &offsets = csr.offsets, &targets = csr.targets;
+
+    vector<int> sources(n);
+    iota(sources.begin(), sources.end(), 1);
+    double scale = 1;
+    if (numPivots != 0 && numPivots < (unsigned) n) {
+        shuffle(sources.begin(), sources.end(), mt19937(seed));
+        sources.resize(numPivots);
+        scale = (double) n / numPivots;
+    }
+
+    ThreadPool pool(numThreads);
+    vector<BrandesScratch> scratch(pool.size());
+    for (BrandesScratch &s: scratch) {
+        s.dist.assign(n + 1, -1);
+        s.order.reserve(n);
+        s.paths.assign(n + 1, 0);
+        s.dependency.assign(n + 1, 0);
+        s.centrality.assign(n + 1, 0);
+    }
+
+    pool.parallelFor(sources.size(), [&](unsigned item, unsigned slot) {
+        BrandesScratch &s = scratch[slot];
+        int source = sources[item];
+        s.order.clear();
+        s.order.push_back(source);
+        s.dist[source] = 0;
+        s.paths[source] = 1;
+        for (size_t head = 0; head < s.order.size(); head++) {
+            int u = s.order[head];
+            for (int i = offsets[u]; i < offsets[u + 1]; i++) {
+                int w = targets[i];
+                if (s.dist[w] == -1) {
+                    s.dist[w] = s.dist[u] + 1;
+                    s.order.push_back(w);
+                }
+                if (s.dist[w] == s.dist[u] + 1) s.paths[w] += s.paths[u];
+            }
+        }
+        // Successors of u on shortest paths are the neighbours one hop further, so no predecessor lists are needed
+        for (size_t i = s.order.size(); i-- > 0;) {
+            int u = s.order[i];
+            for (int j = offsets[u]; j < offsets[u + 1]; j++) {
+                int w = targets[j];
+                if (s.dist[w] == s.dist[u] + 1) s.dependency[u] += s.paths[u] / s.paths[w] * (1 + s.dependency[w]);
+            }
+            if (u != source) s.centrality[u] += s.dependency[u];
+        }
+        for (int u: s.order) {
+            s.dist[u] = -1;
+            s.paths[u] = 0;
+            s.dependency[u] = 0;
+        }
+    });
+
+    vector<double> centrality(n + 1, 0);
+    for (const BrandesScratch &s: scratch) {
+        for (int u = 1; u <= n; u++) centrality[u] += s.centrality[u] * scale;
+    }
+    return centrality;
+}
+
+/**
+ * Computes the PageRank of every airport, where each flight passes a share of its source's score proportional to the
+ * number of airlines flying it. Iterates x' = (1 - d) / n + d * (dangling mass / n + M * x), with M the transposed and
+ * normalised CSR export of the graph, until the L1 change falls below the tolerance. Each product is split into row
+ * blocks across worker threads; the source scores are divided by their weighted outdegree beforehand so the row kernel
+ * is a plain weighted sum over contiguous arrays.
+ * Time Complexity: O(i * (|V| + |E|)) split across the threads, where i is the number of iterations
+ * @param graph - Graph to analyse
+ * @param damping - Probability of following a flight instead of jumping to a random airport
+ * @param tolerance - L1 change between iterations under which the scores are considered converged
+ * @param maxIterations - Maximum number of iterations
+ * @param numThreads - Number of worker threads, or 0 for one per hardware thread
+ * @return PageRank of each node (index 0 is unused), adding up to 1
+ */
+vector<double> CentralityAnalysis::pageRank(const Graph &graph, double damping, double tolerance,
+                                            unsigned maxIterations, unsigned numThreads) {
+    int n = graph.getN();
+    if (n == 0) return vector<double>(1, 0);
+    CsrGraph incoming = CsrGraph::fromGraph(graph, true);
+    vector<double> outWeight(n + 1, 0);
+    for (size_t i = 0; i < incoming.targets.size(); i++) outWeight[incoming.targets[i]] += incoming.payloads[i];
+
+    vector<double> rank(n + 1, 1.0 / n), share(n + 1, 0), next(n + 1, 0);
+    rank[0] = 0;
+    ThreadPool pool(numThreads);
+    const int blockSize = 1024;
+    unsigned numBlocks = (n + blockSize - 1) / blockSize;
+    vector<double> blockChange(numBlocks), blockDangling(numBlocks);
+    const int *offsets = incoming.offsets.data(), *sources = incoming.targets.data();
+    const float *weights = incoming.payloads.data();
+
+    for (unsigned iteration = 0; iteration < maxIterations; iteration++) {
+        pool.parallelFor(numBlocks, [&](unsigned block, unsigned) {
+            int first = 1 + (int) block * blockSize, last = min(n, first + blockSize - 1);
+            double dangling = 0;
+            for (int u = first; u <= last; u++) {
+                if (outWeight[u] == 0) dangling += rank[u];
+                share[u] = outWeight[u] == 0 ? 0 : rank[u] / outWeight[u];
+            }
+            blockDangling[block] = dangling;
+        });
+        double dangling = 0;
+        for (double blockMass: blockDangling) dangling += blockMass;
+        double base = (1 - damping) / n + damping * dangling / n;
+
+        pool.parallelFor(numBlocks, [&](unsigned block, unsigned) {
+            int first = 1 + (int) block * blockSize, last = min(n, first + blockSize - 1);
+            double change = 0;
+            for (int v = first; v <= last; v++) {
+                double sum = 0;
+                for (int i = offsets[v]; i < offsets[v + 1]; i++) sum += weights[i] * share[sources[i]];
+                next[v] = base + damping * sum;
+                change += abs(next[v] - rank[v]);
+            }
+            blockChange[block] = change;
+        });
+        rank.swap(next);
+        double change = 0;
+        for (double blockDelta: blockChange) change += blockDelta;
+        if (change < tolerance) break;
+    }
+    return rank;
+}
+
+/**
+ * Writes the airports with the highest scores as CSV, with a header line
+ * Time Complexity: O(|V| * log(topN))
+ * @param out - Stream to write to
+ * @param graph - Graph the scores were computed from
+ * @param scores - Score of each node (index 0 is unused)
+ * @param scoreName - Name of the score column
+ * @param topN - Number of airports to write, or 0 for all of them
+ */
+void CentralityAnalysis::writeTopCsv(ostream &out, const Graph &graph, const vector<double> &scores,
+                                     const string &scoreName, unsigned topN) {
+    const auto &nodes = graph.getNodes();
+    vector<int> ranking(graph.getN());
+    iota(ranking.begin(), ranking.end(), 1);
+    if (topN == 0 || topN > ranking.size()) topN = ranking.size();
+    partial_sort(ranking.begin(), ranking.begin() + topN, ranking.end(), [&scores](int v1, int v2) {
+        return scores[v1] != scores[v2] ? scores[v1] > scores[v2] : v1 < v2;
+    });
+
+    string text = "rank,airport,name," + scoreName + '\n';
+    for (unsigned i = 0; i < topN; i++) {
+        const Airport &airport = nodes[ranking[i]].airport;
+        text += to_string(i + 1) + ',';
+        ResultFormatter::appendCsvField(text, airport.getCode());
+        text += ',';
+        ResultFormatter::appendCsvField(text, airport.getName());
+        char score[32];
+        snprintf(score, sizeof(score), ",%.10g\n", scores[ranking[i]]);
+        text += score;
+    }
+    out << text;
+}
@@ -0,0 +1,21 @@
+#ifndef CENTRALITYANALYSIS_H
+#define CENTRALITYANALYSIS_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "graph.h"
+
+class CentralityAnalysis {
+public:
+    static std::vector<double> betweenness(const Graph &graph, unsigned numPivots = 0, unsigned numThreads = 0,
+                                           unsigned seed = 1);
+
+    static std::vector<double> pageRank(const Graph &graph, double damping = 0.85, double tolerance = 1e-9,
+                                        unsigned maxIterations = 100, unsigned numThreads = 0);
+
+    static void writeTopCsv(std::ostream &out, const Graph &graph, const std::vector<double> &scores,
+                            const std::string &scoreName, unsigned topN);
+};
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef CODEMAP_H
+#define CODEMAP_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Packs a code of 1 to 4 characters (IATA airport codes, ICAO airline codes, generated codes of small networks) into
+ * a 32 bit integer, one byte per character, so distinct codes give distinct integers
+ * @param code - Code to pack
+ * @return The packed code, or 0 if the code is empty, longer than 4 characters or holds a NUL character
+ */
+inline uint32_t packCode(std::string_view code) {
+    if (code.empty() || code.size() > 4) return 0;
+    uint32_t packed = 0;
+    for (char c: code) {
+        if (c == '\0') return 0;
+        packed = packed << 8 | (unsigned char) c;
+    }
+    return packed;
+}
+
+/**
+ * Map from codes to small values (node indexes, ids, pointers), for lookups that happen once per line of the dataset
+ * files and once per query. Codes that pack into 32 bits (see packCode) live in a flat open addressing table probed
+ * linearly, at most half full, so a lookup is a multiplication and usually a single cache line, with no string
+ * built or hashed; longer codes go to an unordered_map
+ */
+template<typename T>
+class CodeMap {
+private:
+    struct Slot {
+        uint32_t code = 0; // Packed code, 0 if the slot is empty
+        T value{};
+    };
+
+    std::vector<Slot> slots; // Size is 0 or a power of 2
+    unsigned shift = 64; // 64 - log2(slots.size()), to take the top bits of the hash
+    size_t numPacked = 0;
+    std::unordered_map<std::string, T> unpacked;
+
+    size_t slotOf(uint32_t code) const {
+        size_t i = (size_t) ((code * 0x9E3779B97F4A7C15ULL) >> shift);
+        while (slots[i].code != 0 && slots[i].code != code) i = (i + 1) & (slots.size() - 1);
+        return i;
+    }
+
+    void rehash(size_t numSlots) {
+        std::vector<Slot> old(numSlots);
+        old.swap(slots);
+        shift = 64;
+        for (size_t size = numSlots; size > 1; size >>= 1) shift--;
+        for (const Slot &slot: old) {
+            if (slot.code != 0) slots[slotOf(slot.code)] = slot;
+        }
+    }
+
+public:
+    /**
+     * Makes room for the given number of codes, so inserting them doesn't rehash
+     */
+    void reserve(size_t numCodes) {
+        size_t numSlots = 16;
+        while (numSlots < 2 * numCodes) numSlots *= 2;
+        if (numSlots > slots.size()) rehash(numSlots);
+    }
+
+    /**
+     * Maps a code to a value, replacing the value it had
+     * Time Complexity: O(1) (average case)
+     */
+    void insertOrAssign(std::string_view code, T value) {
+        uint32_t packed = packCode(code);
+        if (packed == 0) {
+            unpacked.insert_or_assign(std::string(code), value);
+            return;
+        }
+        if (2 * (numPacked + 1) > slots.size()) reserve(numPacked + 1);
+        Slot &slot = slots[slotOf(packed)];
+        if (slot.code == 0) numPacked++;
+        slot = {packed, value};
+    }
+
+    /**
+     * Returns the value of a code, or nullptr if it has none. The pointer is valid until the next insertion
+     * Time Complexity: O(1) (average case)
+     */
+    const T *find(std::string_view code) const {
+        uint32_t packed = packCode(code);
+        if (packed == 0) {
+            if (unpacked.empty()) return nullptr;
+            auto it = unpacked.find(std::string(code));
+            return it != unpacked.end() ? &it->second : nullptr;
+        }
+        if (slots.empty()) return nullptr;
+        const Slot &slot = slots[slotOf(packed)];
+        return slot.code != 0 ? &slot.value : nullptr;
+    }
+
+    void clear() {
+        slots.clear();
+        shift = 64;
+        numPacked = 0;
+        unpacked.clear();
+    }
+
+    size_t size() const {
+        return numPacked + unpacked.size();
+    }
+
+    /**
+     * Returns the bytes of the flat table; the codes that don't pack are in getUnpacked
+     */
+    size_t slotBytes() const {
+        return slots.capacity() * sizeof(Slot);
+    }
+
+    const std::unordered_map<std::string, T> &getUnpacked() const {
+        return unpacked;
+    }
+};
+
+#endif
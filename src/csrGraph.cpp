@@ -0,0 +1,15 @@
+#include "csrGraph.h"
+
+using namespace std;
+
+bool EdgePayload<float>::fits(const Graph &) {
+    return true;
+}
+
+float EdgePayload<float>::make(const Graph &, const airlineTable &airlines) {
+    return (float) airlines.size();
+}
+
+template struct BasicCsrGraph<int, int, float>;
+template struct BasicCsrGraph<uint16_t, uint8_t, NoAirlines>;
+template struct BasicCsrGraph<int, int, NoAirlines>;
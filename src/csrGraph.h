@@ -0,0 +1,152 @@
+#ifndef CSRGRAPH_H
+#define CSRGRAPH_H
+
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <type_traits>
+#include <vector>
+#include "graph.h"
+
+/**
+ * How the airlines of an edge are stored in a BasicCsrGraph. Specialisations provide
+ * fits(graph), telling whether every edge of the graph can be represented, and make(graph, airlines)
+ */
+template<typename Payload>
+struct EdgePayload;
+
+// No airlines, for passes that only count flights: payloads is left empty
+struct NoAirlines {
+};
+
+template<>
+struct EdgePayload<NoAirlines> {
+    static bool fits(const Graph &) {
+        return true;
+    }
+
+    static NoAirlines make(const Graph &, const airlineTable &) {
+        return {};
+    }
+};
+
+// Number of airlines flying the edge, as a weight
+template<>
+struct EdgePayload<float> {
+    static bool fits(const Graph &graph);
+
+    static float make(const Graph &graph, const airlineTable &airlines);
+};
+
+/**
+ * Compact copy of the graph's edges for whole-graph passes: the edges of node v are
+ * targets[offsets[v] .. offsets[v+1]), with payloads[i] the airlines of edge i as stored by EdgePayload<Payload>.
+ * NodeId must hold every node index and Distance the distances bfsDistance returns, so that small networks can
+ * use narrow types and keep more of the graph in cache. A pass builds its copy and drops it when it ends; the Graph
+ * itself keeps its own layout
+ */
+template<typename NodeId, typename Distance, typename Payload>
+struct BasicCsrGraph {
+    typedef NodeId node_type;
+    typedef Distance distance_type;
+    typedef Payload payload_type;
+
+    // Distance bfsDistance gives to unreachable nodes
+    static constexpr Distance UNREACHABLE = std::numeric_limits<Distance>::max();
+
+    int n = 0; // Number of nodes, numbered from 1 to n like in Graph
+    std::vector<int> offsets; // n + 2 entries, offsets[0] and offsets[1] are 0
+    std::vector<NodeId> targets;
+    std::vector<Payload> payloads; // Empty if Payload is NoAirlines
+
+    static bool fits(const Graph &graph);
+
+    static BasicCsrGraph fromGraph(const Graph &graph, bool reverse = false);
+
+    std::vector<Distance> bfsDistance(int v) const;
+};
+
+/**
+ * Checks if NodeId can hold every node index of a graph and its edges' airlines fit Payload
+ * Time Complexity: O(1)
+ * @param graph - Graph to check
+ * @return true if fromGraph can export the graph, false otherwise
+ */
+template<typename NodeId, typename Distance, typename Payload>
+bool BasicCsrGraph<NodeId, Distance, Payload>::fits(const Graph &graph) {
+    return (unsigned long long) graph.getN() <= (unsigned long long) std::numeric_limits<NodeId>::max() &&
+           EdgePayload<Payload>::fits(graph);
+}
+
+/**
+ * Exports the edges of a graph into CSR arrays
+ * Time Complexity: O(|V| + |E| * m), where m is the largest number of airlines on an Edge
+ * @param graph - Graph to export, which must fit (see fits)
+ * @param reverse - If true, the edges of each node are its incoming edges (targets holds their sources)
+ * @return The exported graph
+ */
+template<typename NodeId, typename Distance, typename Payload>
+BasicCsrGraph<NodeId, Distance, Payload>
+BasicCsrGraph<NodeId, Distance, Payload>::fromGraph(const Graph &graph, bool reverse) {
+    BasicCsrGraph csr;
+    csr.n = graph.getN();
+    const auto &nodes = graph.getNodes();
+    csr.offsets.assign(csr.n + 2, 0);
+    csr.targets.resize(graph.getTotalFlightsAirlineless());
+    if (!std::is_empty<Payload>::value) csr.payloads.resize(graph.getTotalFlightsAirlineless());
+    for (int u = 1; u <= csr.n; u++) {
+        for (const auto &e: nodes[u].adj) csr.offsets[(reverse ? e.dest : u) + 1]++;
+    }
+    for (int v = 1; v <= csr.n; v++) csr.offsets[v + 1] += csr.offsets[v];
+    std::vector<int> position(csr.offsets.begin(), csr.offsets.end() - 1);
+    for (int u = 1; u <= csr.n; u++) {
+        for (const auto &e: nodes[u].adj) {
+            int i = reverse ? position[e.dest]++ : position[u]++;
+            csr.targets[i] = (NodeId) (reverse ? u : e.dest);
+            if constexpr (!std::is_empty<Payload>::value) {
+                csr.payloads[i] = EdgePayload<Payload>::make(graph, e.airlines);
+            }
+        }
+    }
+    return csr;
+}
+
+/**
+ * Computes the distance, in flights, from a node to every node. Distances past UNREACHABLE - 1 are kept at
+ * UNREACHABLE - 1
+ * Time Complexity: O(|V| + |E|)
+ * @param v - Index of the source node
+ * @return vector with the distance to each node (index 0 is unused), UNREACHABLE if it can't be reached
+ */
+template<typename NodeId, typename Distance, typename Payload>
+std::vector<Distance> BasicCsrGraph<NodeId, Distance, Payload>::bfsDistance(int v) const {
+    std::vector<Distance> dist(n + 1, UNREACHABLE);
+    std::queue<NodeId> q;
+    q.push((NodeId) v);
+    dist[v] = 0;
+    while (!q.empty()) {
+        NodeId u = q.front();
+        q.pop();
+        Distance next = dist[u] < UNREACHABLE - 1 ? (Distance) (dist[u] + 1) : dist[u];
+        for (int i = offsets[u]; i < offsets[u + 1]; i++) {
+            NodeId w = targets[i];
+            if (dist[w] == UNREACHABLE) {
+                dist[w] = next;
+                q.push(w);
+            }
+        }
+    }
+    return dist;
+}
+
+// Export used by the whole-graph analyses: int ids and distances, airline counts as weights
+typedef BasicCsrGraph<int, int, float> CsrGraph;
+
+// Flights only, for passes over networks of up to 65535 airports at most 254 flights apart
+typedef BasicCsrGraph<uint16_t, uint8_t, NoAirlines> HopCsrGraph;
+
+extern template struct BasicCsrGraph<int, int, float>;
+extern template struct BasicCsrGraph<uint16_t, uint8_t, NoAirlines>;
+extern template struct BasicCsrGraph<int, int, NoAirlines>;
+
+#endif
@@ -0,0 +1,182 @@
+#include "dataLoader.h"
+#include "instrumentation.h"
+
+using namespace std;
+
+string const DataLoader::DEFAULT_DATASET_DIR = "../dataset";
+
+DataLoader::DataLoader(DataRepository &dataRepository, Graph &graph) : dataRepository(dataRepository), graph(graph) {}
+
+/**
+ * Delegates extracting file info, calling the appropriate functions for each file, and then builds the airport search
+ * index, ranking airports with more flights first
+ * @param datasetDir - Directory containing airlines.csv, airports.csv and flights.csv
+ * @return true if all the files could be read, false otherwise
+ */
+bool DataLoader::extractFileInfo(const string &datasetDir) {
+    if (!extractAirlinesFile(datasetDir + "/airlines.csv") || !extractAirportsFile(datasetDir + "/airports.csv") ||
+        !extractFlightsFile(datasetDir + "/flights.csv")) {
+        return false;
+    }
+    dataRepository.buildSearchIndex([this](const Airport &airport) { return graph.numFlights(airport); });
+    return true;
+}
+
+/**
+ * Extracts and stores the information of airlines.csv
+ * Time Complexity: O(n²) (worst case) | 0(n) (average case), where n is the number of lines of airlines.csv
+ * @param path - Path of the airlines.csv file
+ * @return true if the file could be read, false otherwise
+ */
+bool DataLoader::extractAirlinesFile(const string &path) {
+
+    ScopedMeasurement measurement(Operation::LOAD_AIRLINES);
+    ifstream airlines(path);
+    if (!airlines.is_open()) return false;
+
+    string currentParam, currentLine;
+    string code, name, callsign, country;
+
+    int counter = 0;
+
+    getline(airlines, currentParam); //Ignore first line with just descriptors
+
+    while (getline(airlines, currentLine)) {
+        istringstream iss(currentLine);
+        while (getline(iss, currentParam, ',')) {
+            switch (counter++) {
+                case 0: {
+                    code = currentParam;
+                    break;
+                }
+                case 1: {
+                    name = currentParam;
+                    break;
+                }
+                case 2: {
+                    callsign = currentParam;
+                    break;
+                }
+                case 3: {
+                    country = currentParam;
+                    counter = 0;
+                    break;
+                }
+            }
+            if (counter == 0) {
+                dataRepository.addAirlineEntry(code, name, callsign, country);
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Extracts and stores the information of airports.csv, then builds the city index of the repository and numbers the
+ * cities of the graph nodes from it
+ * Time Complexity: O(n²) (worst case) | 0(n) (average case), where n is the number of lines of airports.csv
+ * @param path - Path of the airports.csv file
+ * @return true if the file could be read, false otherwise
+ */
+bool DataLoader::extractAirportsFile(const string &path) {
+    ScopedMeasurement measurement(Operation::LOAD_AIRPORTS);
+    ifstream airports(path);
+    if (!airports.is_open()) return false;
+
+    string currentParam, currentLine;
+    string code, name, city, country;
+    float latitude = 0, longitude = 0;
+
+    int counter = 0;
+
+    getline(airports, currentParam); //Ignore first line with just descriptors
+
+    while (getline(airports, currentLine)) {
+        istringstream iss(currentLine);
+        while (getline(iss, currentParam, ',')) {
+            switch (counter++) {
+                case 0: {
+                    code = currentParam;
+                    break;
+                }
+                case 1: {
+                    name = currentParam;
+                    break;
+                }
+                case 2: {
+                    city = currentParam;
+                    break;
+                }
+                case 3: {
+                    country = currentParam;
+                    break;
+                }
+                case 4: {
+                    latitude = stof(currentParam);
+                    break;
+                }
+                case 5: {
+                    longitude = stof(currentParam);
+                    counter = 0;
+                    break;
+                }
+            }
+            if (counter == 0) {
+                Airport newAirport = dataRepository.addAirportEntry(code, name, city, country, latitude, longitude);
+                graph.addNode(newAirport);
+            }
+        }
+    }
+    dataRepository.buildCityIndex();
+    graph.setNodeCities(dataRepository);
+    return true;
+}
+
+/**
+ * Extracts and stores the information of flights.csv, then rebuilds the airline index of the graph
+ * Time Complexity: O(n), where n is the number of lines of flights.csv
+ * @param path - Path of the flights.csv file
+ * @return true if the file could be read, false otherwise
+ */
+bool DataLoader::extractFlightsFile(const string &path) {
+
+    ScopedMeasurement measurement(Operation::LOAD_FLIGHTS);
+    ifstream flights(path);
+    if (!flights.is_open()) return false;
+
+    string currentParam, currentLine;
+    string sourceCode, targetCode, airlineCode;
+
+    int counter = 0;
+
+    getline(flights, currentParam); //Ignore first line with just descriptors
+
+    while (getline(flights, currentLine)) {
+        istringstream iss(currentLine);
+        while (getline(iss, currentParam, ',')) {
+            switch (counter++) {
+                case 0: {
+                    sourceCode = currentParam;
+                    break;
+                }
+                case 1: {
+                    targetCode = currentParam;
+                    break;
+                }
+                case 2: {
+                    airlineCode = currentParam;
+                    counter = 0;
+                    break;
+                }
+            }
+            if (counter == 0) {
+                int sourceNode = graph.findAirportNode(sourceCode);
+                int targetNode = graph.findAirportNode(targetCode);
+                const Airline *airline = dataRepository.findAirline(airlineCode);
+                if (airline != nullptr) graph.addEdge(sourceNode, targetNode, *airline);
+            }
+        }
+    }
+    graph.buildAirlineIndex();
+    return true;
+}
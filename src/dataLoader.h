@@ -0,0 +1,28 @@
+#ifndef DATALOADER_H
+#define DATALOADER_H
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include "graph.h"
+#include "dataRepository.h"
+
+class DataLoader {
+private:
+    DataRepository &dataRepository;
+    Graph &graph;
+public:
+    std::string static const DEFAULT_DATASET_DIR;
+
+    DataLoader(DataRepository &dataRepository, Graph &graph);
+
+    bool extractAirlinesFile(const std::string &path);
+
+    bool extractAirportsFile(const std::string &path);
+
+    bool extractFlightsFile(const std::string &path);
+
+    bool extractFileInfo(const std::string &datasetDir = DEFAULT_DATASET_DIR);
+};
+
+#endif
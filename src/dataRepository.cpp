@@ -3,7 +3,10 @@
 //
 
 #include <iostream>
+#include <string_view>
 #include "dataRepository.h"
+#include "instrumentation.h"
+#include "memoryTracker.h"
 
 using namespace std;
 
@@ -13,8 +16,16 @@ const airlineTable &DataRepository::getAirlines() const {
     return airlines;
 }
 
+/**
+ * Replaces the unordered_set of Airlines, reindexing them by code
+ * @param airlines - New unordered_set of Airlines
+ */
 void DataRepository::setAirlines(const airlineTable &airlines) {
     DataRepository::airlines = airlines;
+    MemoryScope memoryScope(MemoryCategory::AIRLINES);
+    airlinesByCode.clear();
+    airlinesByCode.reserve(DataRepository::airlines.size());
+    for (const Airline &airline: DataRepository::airlines) airlinesByCode.insertOrAssign(airline.getCode(), &airline);
 }
 
 /**
@@ -29,7 +40,9 @@ void DataRepository::setAirlines(const airlineTable &airlines) {
  */
 Airline DataRepository::addAirlineEntry(string code, string name, string callsign, string country) {
     Airline newAirline = Airline(code, name, callsign, country);
-    airlines.insert(newAirline);
+    MemoryScope memoryScope(MemoryCategory::AIRLINES);
+    auto [it, inserted] = airlines.insert(newAirline);
+    if (inserted) airlinesByCode.insertOrAssign(it->getCode(), &*it);
     return newAirline;
 }
 
@@ -37,12 +50,31 @@ const airportTable &DataRepository::getAirports() const {
     return airports;
 }
 
+/**
+ * Replaces the unordered_set of Airports, reindexing them by code and by city and dropping the search index built over
+ * the previous ones. The Airports get new ids, in the order of the table
+ * @param airports - New unordered_set of Airports
+ */
 void DataRepository::setAirports(const airportTable &airports) {
     DataRepository::airports = airports;
+    searchIndex.clear();
+    {
+        MemoryScope memoryScope(MemoryCategory::AIRPORTS);
+        airportsByCode.clear();
+        airportsByCode.reserve(DataRepository::airports.size());
+        airportsById.clear();
+        airportsById.reserve(DataRepository::airports.size());
+        for (const Airport &airport: DataRepository::airports) {
+            airportsByCode.insertOrAssign(airport.getCode(), &airport);
+            airportsById.push_back(&airport);
+        }
+    }
+    buildCityIndex();
 }
 
 /**
- * Adds a new entry to the unordered_set of Airports, creating the corresponding Airport object
+ * Adds a new entry to the unordered_set of Airports, creating the corresponding Airport object and giving it the next
+ * airport id. The city index isn't updated until buildCityIndex is called
  * Time Complexity: O(n) (worst case) | O(1) (average case)
  *
  * @param code - Code of the new Airport
@@ -56,64 +88,124 @@ void DataRepository::setAirports(const airportTable &airports) {
 Airport DataRepository::addAirportEntry(string code, string name, string city, string country, float latitude,
                                         float longitude) {
     Airport newAirport = Airport(code, name, city, country, latitude, longitude);
-    airports.insert(newAirport);
+    MemoryScope memoryScope(MemoryCategory::AIRPORTS);
+    auto [it, inserted] = airports.insert(newAirport);
+    if (inserted) {
+        airportsByCode.insertOrAssign(it->getCode(), &*it);
+        airportsById.push_back(&*it);
+    }
     return newAirport;
 }
 
+const vector<const Airport *> &DataRepository::getAirportsById() const {
+    return airportsById;
+}
+
 /**
- * Adds a new Airport value to an entry in the unordered_map of (city, country) pairs
- * Time Complexity: O(n) (worst case) | O(1) (average case)
- *
- * @param city - City of the new Airport
- * @param country - Country of the new Airport
- * @param airport - Airport to add
+ * Returns the Airport with the given id, which must be below the number of Airports
+ * Time Complexity: O(1)
+ * @param id - Id of the Airport, as returned by findAirportsInCity
  */
-void DataRepository::addAirportToCityEntry(const string &city, const string &country, const Airport &airport) {
-    list<Airport> currList = cityToAirports[{city, country}];
-    currList.push_back(airport);
-    cityToAirports.insert_or_assign({city, country}, currList);
+const Airport &DataRepository::getAirport(uint32_t id) const {
+    return *airportsById[id];
 }
 
-const cityToAirportsMap &DataRepository::getCityToAirports() const {
-    return cityToAirports;
+/**
+ * Builds the city index over the current Airports in one pass, replacing the previous one: numbers the (city, country)
+ * pairs, counts the Airports of each city and places their ids in a single array grouped by city, in the order the
+ * Airports were added. Must be called again after adding Airports
+ * Time Complexity: O(n) (average case), where n is the number of Airports
+ */
+void DataRepository::buildCityIndex() {
+    MemoryScope memoryScope(MemoryCategory::CITY_INDEX);
+    cityIds.clear();
+    vector<uint32_t> airportCity(airportsById.size()); // City id of each Airport
+    unordered_set<string_view> countries;
+    for (uint32_t id = 0; id < airportsById.size(); id++) {
+        const Airport &airport = *airportsById[id];
+        auto [it, inserted] = cityIds.try_emplace({airport.getCity(), airport.getCountry()}, (uint32_t) cityIds.size());
+        if (inserted) countries.insert(airport.getCountry());
+        airportCity[id] = it->second;
+    }
+    numCountries = countries.size();
+
+    cityOffsets.assign(cityIds.size() + 1, 0);
+    for (uint32_t city: airportCity) cityOffsets[city + 1]++;
+    for (size_t c = 1; c < cityOffsets.size(); c++) cityOffsets[c] += cityOffsets[c - 1];
+    cityAirports.resize(airportsById.size());
+    vector<uint32_t> next(cityOffsets.begin(), cityOffsets.end() - 1); // Next free position of each city
+    for (uint32_t id = 0; id < airportsById.size(); id++) cityAirports[next[airportCity[id]]++] = id;
+    cityAirports.shrink_to_fit();
 }
 
-void DataRepository::setCityToAirports(const cityToAirportsMap &cityToAirports) {
-    DataRepository::cityToAirports = cityToAirports;
+const cityIdMap &DataRepository::getCityIds() const {
+    return cityIds;
+}
+
+const vector<uint32_t> &DataRepository::getCityOffsets() const {
+    return cityOffsets;
+}
+
+const vector<uint32_t> &DataRepository::getCityAirports() const {
+    return cityAirports;
+}
+
+const CodeMap<const Airline *> &DataRepository::getAirlinesByCode() const {
+    return airlinesByCode;
+}
+
+const CodeMap<const Airport *> &DataRepository::getAirportsByCode() const {
+    return airportsByCode;
 }
 
 /**
  * Finds the Airport object with the given code
+ * Time Complexity: O(1) (average case)
  * @param code - Code of the Airport to be returned
- * @return optional<Airport> value which will contain the Airport object, or be empty if no such Airport was found
+ * @return Pointer to the stored Airport object, valid while the Airports aren't replaced, or nullptr if no such
+ * Airport was found
  */
-std::optional<Airport> DataRepository::findAirport(const string &code) {
-    std::optional<Airport> result;
-    auto it = airports.find(Airport(code));
-    if (it != airports.end()) result = *it;
-    return result;
+const Airport *DataRepository::findAirport(const string &code) const {
+    const Airport *const *airport = airportsByCode.find(code);
+    return airport != nullptr ? *airport : nullptr;
 }
 
 /**
  * Finds the Airline object with the given code
+ * Time Complexity: O(1) (average case)
  * @param code - Code of the Airline to be returned
- * @return optional<Airline> value which will contain the Airline object, or be empty if no such Airline was found
+ * @return Pointer to the stored Airline object, valid while the Airlines aren't replaced, or nullptr if no such
+ * Airline was found
  */
-std::optional<Airline> DataRepository::findAirline(const string &code) {
-    std::optional<Airline> result;
-    auto it = airlines.find(Airline(code));
-    if (it != airlines.end()) result = *it;
-    return result;
+const Airline *DataRepository::findAirline(const string &code) const {
+    const Airline *const *airline = airlinesByCode.find(code);
+    return airline != nullptr ? *airline : nullptr;
 }
 
 /**
- * Finds the Airport objects with the given city
+ * Finds the id of a city in the city index
+ * Time Complexity: O(1) (average case)
+ * @param city - City to be found
+ * @param country - Country the city belongs to
+ * @return Id of the city, below getNumCities, or -1 if no Airport is in it
+ */
+int DataRepository::findCity(const std::string &city, const std::string &country) const {
+    auto it = cityIds.find({city, country});
+    return it != cityIds.end() ? (int) it->second : -1;
+}
+
+/**
+ * Finds the Airports of the given city in the city index, without copying them
+ * Time Complexity: O(1) (average case)
  * @param city - City whose airports should be found
  * @param country - Country the city belongs to (used to differentiate same name cities)
- * @return list<Airport> containing the Airports in the given city
+ * @return Span with the ids of the Airports in the given city (see getAirport), in the order they were added, valid
+ * until the city index is rebuilt; empty if the city is unknown
  */
-list<Airport> DataRepository::findAirportsInCity(const std::string &city, const std::string &country) {
-    return cityToAirports.at({city, country});
+Span<uint32_t> DataRepository::findAirportsInCity(const std::string &city, const std::string &country) const {
+    int id = findCity(city, country);
+    if (id == -1) return {};
+    return {cityAirports.data() + cityOffsets[id], cityAirports.data() + cityOffsets[id + 1]};
 }
 
 /**
@@ -122,8 +214,8 @@ list<Airport> DataRepository::findAirportsInCity(const std::string &city, const
  * @param country - Country to be validated
  * @return true if the combination is valid, false if it is not
  */
-bool DataRepository::checkValidCityCountry(const std::string &city, const std::string &country) {
-    return cityToAirports.find({city, country}) != cityToAirports.end();
+bool DataRepository::checkValidCityCountry(const std::string &city, const std::string &country) const {
+    return findCity(city, country) != -1;
 }
 
 /**
@@ -133,10 +225,12 @@ bool DataRepository::checkValidCityCountry(const std::string &city, const std::s
  * @param maxDistance - Max valid distance of the airport to the location
  * @return List of Airports with all the airports within a distance of maxDistance
  */
-list<Airport> DataRepository::findAirportsInLocation(float latitude, float longitude, float maxDistance) {
+list<Airport> DataRepository::findAirportsInLocation(float latitude, float longitude, float maxDistance) const {
+    ScopedMeasurement measurement(Operation::GEO_LOOKUP);
     Position startPos = Position(latitude, longitude);
     list<Airport> valid;
-    for (auto aport: airports) {
+    for (const Airport &aport: airports) {
+        measurement.nodeExpanded();
         if (aport.getLocation().getDistance(startPos) <= maxDistance) {
             valid.push_back(aport);
         }
@@ -145,14 +239,46 @@ list<Airport> DataRepository::findAirportsInLocation(float latitude, float longi
 }
 
 /**
- * Computes total number of different countries
- * Time Complexity: O(n²) (worst case) | 0(n) (average case), where n is the size of cityToAirport
+ * Returns total number of different (city, country) pairs
+ * Time Complexity: O(1)
+ * @return Number of different cities
+ */
+unsigned DataRepository::getNumCities() const {
+    return cityIds.size();
+}
+
+/**
+ * Returns total number of different countries
+ * Time Complexity: O(1)
  * @return Number of different countries
  */
-unsigned DataRepository::getTotalNumCountries(){
-    unordered_set<string> countries;
-    for(auto p: cityToAirports) countries.insert(p.first.second);
-    return countries.size();
+unsigned DataRepository::getTotalNumCountries() const {
+    return numCountries;
 }
 
 
+
+/**
+ * Builds the index used by searchAirports over the current Airports. Must be called again after adding Airports
+ * Time Complexity: O(k log k), where k is the number of keys of the index (see AirportSearchIndex::build)
+ * @param weight - Gives the weight of each Airport, heavier airports being suggested first among equal matches
+ */
+void DataRepository::buildSearchIndex(const function<unsigned(const Airport &)> &weight) {
+    searchIndex.build(airports, weight);
+}
+
+const AirportSearchIndex &DataRepository::getSearchIndex() const {
+    return searchIndex;
+}
+
+/**
+ * Finds the Airports whose code, name or city (or a word of the name or city) start with the given text, or with
+ * something within maxEdits edits of it. Empty if buildSearchIndex wasn't called
+ * @param text - Text to search for, case and punctuation being ignored
+ * @param limit - Max number of Airports to return
+ * @param maxEdits - Max number of edits, or -1 to allow more the longer the text is
+ * @return vector with the matching Airports, best first
+ */
+vector<AirportMatch> DataRepository::searchAirports(const string &text, size_t limit, int maxEdits) const {
+    return searchIndex.search(text, limit, maxEdits);
+}
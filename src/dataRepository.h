@@ -10,6 +10,9 @@
 #include <algorithm>
 #include "airport.h"
 #include "airline.h"
+#include "airportSearchIndex.h"
+#include "codeMap.h"
+#include "span.h"
 
 struct pairCityHash {
     std::size_t operator()(std::pair<std::string, std::string> const &pair) const {
@@ -27,18 +30,31 @@ struct pairCityEquals {
     }
 };
 
-typedef std::unordered_map<std::pair<std::string, std::string>, std::list<Airport>, pairCityHash, pairCityEquals> cityToAirportsMap;
-typedef std::unordered_set<std::pair<std::string, std::string>, pairCityHash, pairCityEquals> cityTable;
+typedef std::unordered_map<std::pair<std::string, std::string>, uint32_t, pairCityHash, pairCityEquals> cityIdMap;
 
 
 class DataRepository {
 private:
     airlineTable airlines;
     airportTable airports;
-    cityToAirportsMap cityToAirports;
+    // Elements of airlines and airports by code; the tables' nodes don't move, so the pointers stay valid
+    CodeMap<const Airline *> airlinesByCode;
+    CodeMap<const Airport *> airportsByCode;
+    std::vector<const Airport *> airportsById; // Elements of airports in the order they were added, by airport id
+    // City index, built by buildCityIndex: cities are numbered in the order their first airport was added, and the ids
+    // of the airports of city c are cityAirports[cityOffsets[c] .. cityOffsets[c + 1]), in the order they were added
+    cityIdMap cityIds;
+    std::vector<uint32_t> cityOffsets;
+    std::vector<uint32_t> cityAirports;
+    unsigned numCountries = 0; // Number of different countries of the indexed cities
+    AirportSearchIndex searchIndex; // Over airports, built by buildSearchIndex
 public:
     DataRepository();
 
+    DataRepository(const DataRepository &) = delete;
+
+    DataRepository &operator=(const DataRepository &) = delete;
+
     const airlineTable &getAirlines() const;
 
     void setAirlines(const airlineTable &airlines);
@@ -47,28 +63,49 @@ public:
 
     void setAirports(const airportTable &airports);
 
-    const cityToAirportsMap &getCityToAirports() const;
+    const std::vector<const Airport *> &getAirportsById() const;
+
+    const Airport &getAirport(uint32_t id) const;
+
+    const cityIdMap &getCityIds() const;
+
+    const std::vector<uint32_t> &getCityOffsets() const;
+
+    const std::vector<uint32_t> &getCityAirports() const;
 
-    void setCityToAirports(const cityToAirportsMap &cityToAirports);
+    const CodeMap<const Airline *> &getAirlinesByCode() const;
 
-    std::optional<Airport> findAirport(const std::string &code);
+    const CodeMap<const Airport *> &getAirportsByCode() const;
 
-    std::optional<Airline> findAirline(const std::string &code);
+    const Airport *findAirport(const std::string &code) const;
 
-    std::list<Airport> findAirportsInCity(const std::string &city, const std::string &country);
+    const Airline *findAirline(const std::string &code) const;
+
+    int findCity(const std::string &city, const std::string &country) const;
+
+    Span<uint32_t> findAirportsInCity(const std::string &city, const std::string &country) const;
 
     Airline addAirlineEntry(std::string code, std::string name, std::string callsign, std::string country);
 
     Airport addAirportEntry(std::string code, std::string name, std::string city, std::string country, float latitude,
                             float longitude);
 
-    void addAirportToCityEntry(const std::string &city, const std::string &country, const Airport &airport);
+    void buildCityIndex();
+
+    bool checkValidCityCountry(const std::string &city, const std::string &country) const;
+
+    std::list<Airport> findAirportsInLocation(float latitude, float longitude, float maxDistance) const;
+
+    unsigned int getNumCities() const;
+
+    unsigned int getTotalNumCountries() const;
 
-    bool checkValidCityCountry(const std::string &city, const std::string &country);
+    void buildSearchIndex(const std::function<unsigned(const Airport &)> &weight = nullptr);
 
-    std::list<Airport> findAirportsInLocation(float latitude, float longitude, float maxDistance);
+    const AirportSearchIndex &getSearchIndex() const;
 
-    unsigned int getTotalNumCountries();
+    std::vector<AirportMatch> searchAirports(const std::string &text, size_t limit = AirportSearchIndex::DEFAULT_LIMIT,
+                                             int maxEdits = -1) const;
 };
 
 
@@ -0,0 +1,82 @@
+#include "eccentricityCache.h"
+#include <algorithm>
+#include <numeric>
+#include "resultFormatter.h"
+
+using namespace std;
+
+/**
+ * Computes the eccentricity of every airport in one parallel all-sources pass, and derives the radius, diameter,
+ * centre and periphery from them. As the network isn't strongly connected, eccentricities only count reachable
+ * airports, so the radius and centre are taken within the largest strongly connected component (otherwise an airport
+ * whose only flight leads to a dead end would be central).
+ * Time Complexity: O(|V|(|V+E|)), split across the threads
+ * @param graph - Graph to analyse
+ * @param numThreads - Number of worker threads, or 0 for one per hardware thread
+ * @return The eccentricities
+ */
+Eccentricities Eccentricities::compute(const Graph &graph, unsigned numThreads) {
+    Eccentricities result;
+    result.graphVersion = graph.getVersion();
+    result.eccentricity = graph.eccentricities(numThreads);
+    vector<int> component = graph.sccComponents();
+    vector<int> componentSize(graph.getN() + 1, 0);
+    int largest = -1;
+    for (int v = 1; v <= graph.getN(); v++) {
+        int size = ++componentSize[component[v]];
+        if (largest == -1 || size > componentSize[largest]) largest = component[v];
+        result.diameter = max(result.diameter, result.eccentricity[v]);
+    }
+    result.radius = result.diameter;
+    for (int v = 1; v <= graph.getN(); v++) {
+        if (component[v] == largest) result.radius = min(result.radius, result.eccentricity[v]);
+    }
+    for (int v = 1; v <= graph.getN(); v++) {
+        if (component[v] == largest && result.eccentricity[v] == result.radius) result.centre.push_back(v);
+        if (result.eccentricity[v] == result.diameter) result.periphery.push_back(v);
+    }
+    return result;
+}
+
+/**
+ * Writes the eccentricity of every airport as CSV, with a header line, from the most central to the most peripheral
+ * @param out - Stream to write to
+ * @param graph - Graph the eccentricities were computed from
+ */
+void Eccentricities::writeCsv(ostream &out, const Graph &graph) const {
+    const auto &nodes = graph.getNodes();
+    vector<int> order(graph.getN());
+    iota(order.begin(), order.end(), 1);
+    stable_sort(order.begin(), order.end(), [this](int v1, int v2) { return eccentricity[v1] < eccentricity[v2]; });
+
+    string text = "airport,name,eccentricity,role\n";
+    for (int v: order) {
+        ResultFormatter::appendCsvField(text, nodes[v].airport.getCode());
+        text += ',';
+        ResultFormatter::appendCsvField(text, nodes[v].airport.getName());
+        text += ',' + to_string(eccentricity[v]) + ',';
+        if (eccentricity[v] == diameter) text += "periphery";
+        else if (binary_search(centre.begin(), centre.end(), v)) text += "centre";
+        text += '\n';
+    }
+    out << text;
+}
+
+/**
+ * @param numThreads - Number of worker threads computing the eccentricities, or 0 for one per hardware thread
+ */
+EccentricityCache::EccentricityCache(unsigned numThreads) : numThreads(numThreads) {}
+
+/**
+ * Returns the eccentricities of the graph, computing them on the first call and whenever the graph changed since.
+ * Concurrent callers wait for a single computation.
+ * Time Complexity: O(1) if cached, O(|V|(|V+E|)) split across the threads otherwise
+ * @param graph - Graph whose eccentricities are wanted
+ * @return The eccentricities, which stay valid even if the cache is refreshed later
+ */
+shared_ptr<const Eccentricities> EccentricityCache::get(const Graph &graph) {
+    lock_guard<std::mutex> lock(mutex);
+    if (!current || current->graphVersion != graph.getVersion())
+        current = make_shared<const Eccentricities>(Eccentricities::compute(graph, numThreads));
+    return current;
+}
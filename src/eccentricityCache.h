@@ -0,0 +1,35 @@
+#ifndef ECCENTRICITYCACHE_H
+#define ECCENTRICITYCACHE_H
+
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include "graph.h"
+
+struct Eccentricities {
+    unsigned long long graphVersion = 0; // Version of the graph they were computed from
+    std::vector<int> eccentricity; // Eccentricity of each node (index 0 is unused)
+    int radius = 0; // Smallest eccentricity of an airport in the largest strongly connected component
+    int diameter = 0; // Largest eccentricity
+    std::vector<int> centre; // Airports of the largest strongly connected component whose eccentricity is the radius
+    std::vector<int> periphery; // Airports whose eccentricity is the diameter
+
+    static Eccentricities compute(const Graph &graph, unsigned numThreads = 0);
+
+    void writeCsv(std::ostream &out, const Graph &graph) const;
+};
+
+class EccentricityCache {
+private:
+    unsigned numThreads;
+    std::shared_ptr<const Eccentricities> current;
+    mutable std::mutex mutex;
+
+public:
+    explicit EccentricityCache(unsigned numThreads = 0);
+
+    std::shared_ptr<const Eccentricities> get(const Graph &graph);
+};
+
+#endif
@@ -1,14 +1,24 @@
 #include "graph.h"
+#include "csrGraph.h"
+#include "instrumentation.h"
+#include "memoryTracker.h"
+#include "arena.h"
+#include "threadPool.h"
 #include <algorithm>
+#include <numeric>
+#include <climits>
+#include <tuple>
 
 using namespace std;
 
 // Constructor: nr nodes
-Graph::Graph(int num) : n(num), nodes(num + 1) {
+Graph::Graph(int num) : n(num), edgeArena(make_unique<Arena>()) {
+    nodes.reserve(num + 1);
+    for (int i = 0; i <= num; i++) nodes.push_back({Airport(), pmr::list<Edge>(edgeArena.get())});
 }
 
 /**
- * Adds an edge to the graph
+ * Adds an edge to the graph, updating the global flight counters
  * Time Complexity: O(1)
  * @param src - Number of the source node
  * @param dest - Number of the destination node
@@ -16,11 +26,15 @@ Graph::Graph(int num) : n(num), nodes(num + 1) {
  */
 void Graph::addEdge(int src, int dest, const airlineTable &connectingAirlines) {
     if (src < 1 || src > n || dest < 1 || dest > n) return;
-    nodes[src].adj.push_back({dest, connectingAirlines});
+    version++;
+    MemoryScope memoryScope(MemoryCategory::GRAPH_EDGES);
+    nodes[src].adj.push_back({dest, airlineTable(connectingAirlines, edgeArena.get())});
+    totalFlightsAirlineless++;
+    totalFlights += (int) connectingAirlines.size();
 }
 
 /**
- * Adds an edge to the graph
+ * Adds an edge to the graph, updating the global flight counters
  * Time Complexity: O(outdegree(src))
  * @param src - Number of the source node
  * @param dest - Number of the destination node
@@ -28,12 +42,20 @@ void Graph::addEdge(int src, int dest, const airlineTable &connectingAirlines) {
  */
 void Graph::addEdge(int src, int dest, const Airline &airline) {
     if (src < 1 || src > n || dest < 1 || dest > n) return;
+    version++;
+    MemoryScope memoryScope(MemoryCategory::GRAPH_EDGES);
 
     auto existingEdgeIt = std::find_if(nodes[src].adj.begin(), nodes[src].adj.end(),
-                                       [dest](Edge e) { return e.dest == dest; });
+                                       [dest](const Edge &e) { return e.dest == dest; });
     if (existingEdgeIt != nodes[src].adj.end()) {
-        existingEdgeIt->airlines.insert(airline);
-    } else nodes[src].adj.push_back({dest, airlineTable({airline})});
+        if (existingEdgeIt->airlines.insert(airline).second) totalFlights++;
+    } else {
+        airlineTable airlines(edgeArena.get());
+        airlines.insert(airline);
+        nodes[src].adj.push_back({dest, std::move(airlines)});
+        totalFlightsAirlineless++;
+        totalFlights++;
+    }
 }
 
 /**
@@ -42,15 +64,40 @@ void Graph::addEdge(int src, int dest, const Airline &airline) {
  * @param airport - Airport the new node will represent
  */
 void Graph::addNode(const Airport &airport) {
-    nodes.push_back({airport});
-    airportToNode[airport] = ++n;
+    version++;
+    {
+        MemoryScope memoryScope(MemoryCategory::GRAPH_NODES);
+        nodes.push_back({airport, pmr::list<Edge>(edgeArena.get())});
+    }
+    MemoryScope memoryScope(MemoryCategory::CODE_TO_NODE);
+    codeToNode.insertOrAssign(airport.getCode(), ++n);
+}
+
+/**
+ * Numbers the city of every node with the id of its (city, country) in the city index of a repository, which
+ * numDestinations and numCitiesInXFlights count. Must be called again after adding nodes or rebuilding the index
+ * Time Complexity: O(|V|) (average case)
+ * @param dataRepository - Repository whose city index is up to date (see DataRepository::buildCityIndex)
+ */
+void Graph::setNodeCities(const DataRepository &dataRepository) {
+    numCities = dataRepository.getNumCities();
+    for (int v = 1; v <= n; v++) {
+        const Airport &airport = nodes[v].airport;
+        int city = dataRepository.findCity(airport.getCity(), airport.getCountry());
+        nodes[v].city = city != -1 ? (uint32_t) city : NO_CITY;
+    }
 }
 
 int Graph::getN() const {
     return n;
 }
 
+unsigned long long Graph::getVersion() const {
+    return version;
+}
+
 void Graph::setN(int n) {
+    version++;
     Graph::n = n;
 }
 
@@ -58,26 +105,39 @@ const vector<Graph::Node> &Graph::getNodes() const {
     return nodes;
 }
 
+const Arena &Graph::getEdgeArena() const {
+    return *edgeArena;
+}
+
+/**
+ * Replaces the nodes of the graph, recomputing the global flight counters
+ * Time Complexity: O(|V|+|E|)
+ * @param nodes - New nodes of the graph
+ */
 void Graph::setNodes(const vector<Node> &nodes) {
+    version++;
     Graph::nodes = nodes;
+    totalFlights = 0;
+    totalFlightsAirlineless = 0;
+    for (int i = 1; i < (int) nodes.size(); i++) {
+        totalFlightsAirlineless += (int) nodes[i].adj.size();
+        for (const Edge &e: nodes[i].adj) totalFlights += (int) e.airlines.size();
+    }
 }
 
 /**
  * Returns the index of the node representing the airport with the given code
+ * Time Complexity: O(1) (average case)
  * @param code - Code of the Airport whose node index should be found
  * @return Index of the node representing the given airport, or 0 if no node represents it
  */
-int Graph::findAirportNode(const string &code) {
-    auto it = airportToNode.find(Airport(code));
-    return it != airportToNode.end() ? it->second : 0;
-}
-
-const airportMap<int> &Graph::getAirportToNode() const {
-    return airportToNode;
+int Graph::findAirportNode(const string &code) const {
+    const int *node = codeToNode.find(code);
+    return node != nullptr ? *node : 0;
 }
 
-void Graph::setAirportToNode(const airportMap<int> &airportToNode) {
-    Graph::airportToNode = airportToNode;
+const CodeMap<int> &Graph::getCodeToNode() const {
+    return codeToNode;
 }
 
 const airlineTable &Graph::getAirlines() const {
@@ -85,6 +145,7 @@ const airlineTable &Graph::getAirlines() const {
 }
 
 void Graph::setAirlines(const airlineTable &airlines) {
+    version++;
     Graph::airlines = airlines;
 }
 
@@ -96,7 +157,7 @@ void Graph::setAirlines(const airlineTable &airlines) {
  */
 unsigned Graph::numFlights(const Airport &airport) const {
     unsigned total = 0;
-    int v = airportToNode.at(airport);
+    int v = findAirportNode(airport.getCode());
     for (const Edge &e: nodes[v].adj) {
         total += e.airlines.size();
     }
@@ -106,7 +167,11 @@ unsigned Graph::numFlights(const Airport &airport) const {
 
 /**
  * Finds one of the routes connecting one of the source nodes to the destination node that has the minimum amount of flights, avoiding invalid Edges.
- * Time Complexity: O(|V|+|E| * n * m) (worst case) | O(|V|+|E| * n) (average case), where n is the size of validAirlines and m is the largest number of airlines on an Edge
+ * Small airline restrictions are answered through the airline index when it is up to date (see buildAirlineIndex).
+ * Each reached node only records the node and edge it was reached through, and the route (with the valid airlines of
+ * each of its flights) is built once the destination is reached. Search state is kept in the thread's scratch arena,
+ * so concurrent searches on the same graph are safe.
+ * Time Complexity: O(|V|+|E| * m) (worst case) | O(|V|+|E|) (average case), where m is the smallest of the size of validAirlines and the largest number of airlines on an Edge
  * 
  * @param source - Index of the source node
  * @param destination - Index of the destination node
@@ -114,41 +179,299 @@ unsigned Graph::numFlights(const Airport &airport) const {
  * @return A list of pair<airlineTable, string>, each representing the airlines that connected the previous pair to this one, and the code of the connected Airport
 */
 list<pair<airlineTable, string>>
-Graph::shortest_path_bfs(list<int> source, int destination, airlineTable validAirlines) {
+Graph::shortest_path_bfs(const list<int> &source, int destination, const airlineTable &validAirlines) const {
     if (std::find(source.begin(), source.end(), destination) != source.end()) return {};
+    if (hasAirlineIndex() && validAirlines.size() <= MAX_AIRLINE_VIEW_SIZE)
+        return shortestPathAirlineView(source, destination, validAirlines);
 
-    for (int i = 1; i <= n; i++) {
-        nodes[i].visited = false;
-        nodes[i].dist = -1;
-        nodes[i].predecessing_trip = {};
-    }
-    queue<int> q; // queue of unvisited nodes
+    ScopedMeasurement measurement(Operation::SHORTEST_PATH_BFS);
+    ScratchScope scratch;
+    pmr::vector<int> parent(n + 1, -1, scratch.resource()); // Node each node was reached from, 0 for the sources
+    pmr::vector<const Edge *> parentEdge(n + 1, nullptr, scratch.resource()); // Edge each node was reached through
+    queue<int, pmr::deque<int>> q(scratch.resource()); // queue of unvisited nodes
     for (int i: source) {
         q.push(i);
-        nodes[i].visited = true;
-        nodes[i].dist = 0;
-        nodes[i].predecessing_trip = {{{}, nodes[i].airport.getCode()}};
+        parent[i] = 0;
     }
 
-    while (!q.empty()) { // while there are still unvisited nodes
+    while (!q.empty() && parent[destination] == -1) { // while there are still unvisited nodes
         int u = q.front();
         q.pop();
-        // show node order
-        //cout << u << " ";
-        for (auto e: nodes[u].adj) {
+        measurement.nodeExpanded();
+        for (const Edge &e: nodes[u].adj) {
+            measurement.edgeScanned();
             int w = e.dest;
-            airlineTable available_airlines = intersectTables(validAirlines, e.airlines);
-            if (!nodes[w].visited && !available_airlines.empty()) {
-                q.push(w);
-                nodes[w].visited = true;
-                nodes[w].dist = nodes[u].dist + 1;
-                nodes[w].predecessing_trip = nodes[u].predecessing_trip;
-                nodes[w].predecessing_trip.push_back({available_airlines, nodes[w].airport.getCode()});
-            }
+            if (parent[w] != -1) continue;
+            measurement.airlineIntersection();
+            if (!hasCommonAirline(validAirlines, e.airlines)) continue;
+            q.push(w);
+            parent[w] = u;
+            parentEdge[w] = &e;
             if (w == destination) break;
         }
     }
-    return nodes[destination].predecessing_trip;
+    if (parent[destination] == -1) return {};
+
+    list<pair<airlineTable, string>> path;
+    int v = destination;
+    for (; parent[v] != 0; v = parent[v])
+        path.push_front({intersectTables(validAirlines, parentEdge[v]->airlines), nodes[v].airport.getCode()});
+    path.push_front({{}, nodes[v].airport.getCode()});
+    return path;
+}
+
+/**
+ * Moves every node to a new index, remapping the edges and codeToNode, so callers keep finding airports by code.
+ * The edges are copied into a new arena in the new order and the airline index is rebuilt if it was up to date.
+ * Time Complexity: O(|V| + |E|), plus rebuilding the airline index
+ * @param newIndex - New index of each node (index 0 is unused); must be a permutation of 1..n
+ */
+void Graph::renumberNodes(const vector<int> &newIndex) {
+    bool rebuildIndex = hasAirlineIndex();
+    version++;
+    vector<int> oldIndex(n + 1, 0);
+    for (int v = 1; v <= n; v++) oldIndex[newIndex[v]] = v;
+
+    // Copy the edges into a fresh arena in the new order, so the edges of nearby nodes also end up near each other in
+    // memory, and the old arena (with whatever its tables outgrew) is released as a whole
+    auto arena = make_unique<Arena>();
+    vector<Node> renumbered;
+    {
+        MemoryScope memoryScope(MemoryCategory::GRAPH_NODES);
+        renumbered.reserve(n + 1);
+        renumbered.push_back({Airport(), pmr::list<Edge>(arena.get())});
+    }
+    for (int v = 1; v <= n; v++) {
+        Node &node = nodes[oldIndex[v]];
+        {
+            MemoryScope memoryScope(MemoryCategory::GRAPH_NODES);
+            renumbered.push_back({std::move(node.airport), pmr::list<Edge>(arena.get()), node.city});
+        }
+        MemoryScope memoryScope(MemoryCategory::GRAPH_EDGES);
+        for (const Edge &e: node.adj) {
+            renumbered.back().adj.push_back({newIndex[e.dest], airlineTable(e.airlines, arena.get())});
+        }
+    }
+    nodes.swap(renumbered);
+    edgeArena.swap(arena);
+    renumbered.clear(); // Before its arena is released
+    for (int v = 1; v <= n; v++) codeToNode.insertOrAssign(nodes[v].airport.getCode(), v);
+    if (rebuildIndex) buildAirlineIndex();
+}
+
+/**
+ * Computes a new index for every node following the given order. RCM visits each connected component (ignoring the
+ * direction of flights) breadth-first from a least connected airport, neighbours in increasing degree, and reverses
+ * the result, which keeps the airports a search expands together close in memory.
+ * Time Complexity: O(|V| + |E| * log(d)) for RCM, O(|V| * log(|V|) + |E|) for DEGREE, where d is the largest degree
+ * @param order - Order to follow
+ * @return New index of each node (index 0 is unused), to pass to renumberNodes
+ */
+vector<int> Graph::computeNodeOrder(NodeOrder order) const {
+    vector<int> degree(n + 1, 0);
+    vector<vector<int>> neighbours(order == NodeOrder::RCM ? n + 1 : 0);
+    for (int u = 1; u <= n; u++) {
+        for (const Edge &e: nodes[u].adj) {
+            degree[u]++;
+            degree[e.dest]++;
+            if (order == NodeOrder::RCM) {
+                neighbours[u].push_back(e.dest);
+                neighbours[e.dest].push_back(u);
+            }
+        }
+    }
+
+    vector<int> sequence(n); // Nodes in their new order
+    iota(sequence.begin(), sequence.end(), 1);
+    if (order == NodeOrder::DEGREE) {
+        stable_sort(sequence.begin(), sequence.end(), [&degree](int v1, int v2) { return degree[v1] > degree[v2]; });
+    } else if (order == NodeOrder::RCM) {
+        auto byDegree = [&degree](int v1, int v2) {
+            return degree[v1] != degree[v2] ? degree[v1] < degree[v2] : v1 < v2;
+        };
+        vector<int> roots(sequence);
+        sort(roots.begin(), roots.end(), byDegree);
+        vector<bool> visited(n + 1, false);
+        sequence.clear();
+        for (int root: roots) {
+            if (visited[root]) continue;
+            visited[root] = true;
+            sequence.push_back(root);
+            for (size_t head = sequence.size() - 1; head < sequence.size(); head++) {
+                vector<int> &next = neighbours[sequence[head]];
+                sort(next.begin(), next.end(), byDegree);
+                for (int w: next) {
+                    if (visited[w]) continue;
+                    visited[w] = true;
+                    sequence.push_back(w);
+                }
+            }
+        }
+        reverse(sequence.begin(), sequence.end());
+    }
+
+    vector<int> newIndex(n + 1, 0);
+    for (int i = 0; i < n; i++) newIndex[sequence[i]] = i + 1;
+    return newIndex;
+}
+
+/**
+ * Renumbers the nodes following the given order (see computeNodeOrder and renumberNodes)
+ * @param order - Order to follow
+ */
+void Graph::reorderNodes(NodeOrder order) {
+    if (order != NodeOrder::LOAD) renumberNodes(computeNodeOrder(order));
+}
+
+/**
+ * Builds the airline index: the edges of every node are split into one entry per airline and sorted by (airline,
+ * destination), so the edges a given airline flies from a node are a contiguous range. Searches restricted to a few
+ * airlines then only look at the edges those airlines fly. Any later change to the graph makes the index stale, in
+ * which case searches fall back to the full adjacency lists until it is rebuilt.
+ * Time Complexity: O(|V| + F * log(F)), where F is the number of (source, target, airline) flights
+ */
+void Graph::buildAirlineIndex() {
+    MemoryScope memoryScope(MemoryCategory::GRAPH_EDGES);
+    indexedAirlines.clear();
+    airlineIds.clear();
+    for (int v = 1; v <= n; v++) {
+        for (const Edge &e: nodes[v].adj) {
+            for (const Airline &airline: e.airlines) {
+                if (airlineIds.find(airline.getCode()) != nullptr) continue;
+                airlineIds.insertOrAssign(airline.getCode(), 0);
+                indexedAirlines.push_back(airline);
+            }
+        }
+    }
+    sort(indexedAirlines.begin(), indexedAirlines.end(),
+         [](const Airline &a1, const Airline &a2) { return a1.getCode() < a2.getCode(); });
+    for (int id = 0; id < (int) indexedAirlines.size(); id++) airlineIds.insertOrAssign(indexedAirlines[id].getCode(), id);
+
+    airlineEdgeOffsets.assign(n + 2, 0);
+    airlineEdges.clear();
+    airlineEdges.reserve(totalFlights);
+    for (int v = 1; v <= n; v++) {
+        airlineEdgeOffsets[v] = (int) airlineEdges.size();
+        for (const Edge &e: nodes[v].adj) {
+            for (const Airline &airline: e.airlines) airlineEdges.push_back({*airlineIds.find(airline.getCode()), e.dest});
+        }
+        sort(airlineEdges.begin() + airlineEdgeOffsets[v], airlineEdges.end(),
+             [](const AirlineEdge &e1, const AirlineEdge &e2) {
+                 return e1.airline != e2.airline ? e1.airline < e2.airline : e1.dest < e2.dest;
+             });
+    }
+    airlineEdgeOffsets[n + 1] = (int) airlineEdges.size();
+
+    unordered_map<unsigned long long, int> stateIds;
+    arrivalStates.resize(airlineEdges.size());
+    for (size_t i = 0; i < airlineEdges.size(); i++) {
+        unsigned long long key = (unsigned long long) airlineEdges[i].dest << 32 | (unsigned) airlineEdges[i].airline;
+        arrivalStates[i] = stateIds.emplace(key, (int) stateIds.size()).first->second;
+    }
+    numArrivalStates = (int) stateIds.size();
+    airlineIndexVersion = version;
+}
+
+/**
+ * Checks whether the airline index was built from the current state of the graph
+ * Time Complexity: O(1)
+ * @return true if the airline index is up to date, false otherwise
+ */
+bool Graph::hasAirlineIndex() const {
+    return airlineIndexVersion == version;
+}
+
+int Graph::getNumIndexedAirlines() const {
+    return (int) indexedAirlines.size();
+}
+
+const Airline &Graph::getIndexedAirline(int id) const {
+    return indexedAirlines[id];
+}
+
+/**
+ * Returns the id the airline index gave to the airline with the given code
+ * Time Complexity: O(1) (average case)
+ * @param code - Code of the Airline
+ * @return Id of the Airline, or -1 if no indexed edge is flown by it
+ */
+int Graph::findAirlineId(const string &code) const {
+    const int *id = airlineIds.find(code);
+    return id != nullptr ? *id : -1;
+}
+
+/**
+ * Returns the edges the given airline flies from a node, according to the airline index
+ * Time Complexity: O(log(outdegree(v) * m)), where m is the largest number of airlines on an Edge
+ * @param v - Index of the source node
+ * @param airline - Id of the Airline
+ * @return Range [first, second) of the node's index entries flown by the airline, sorted by destination
+ */
+pair<const Graph::AirlineEdge *, const Graph::AirlineEdge *> Graph::airlineEdgesOf(int v, int airline) const {
+    const AirlineEdge *begin = airlineEdges.data() + airlineEdgeOffsets[v];
+    const AirlineEdge *end = airlineEdges.data() + airlineEdgeOffsets[v + 1];
+    const AirlineEdge *first = lower_bound(begin, end, airline,
+                                           [](const AirlineEdge &e, int id) { return e.airline < id; });
+    const AirlineEdge *last = upper_bound(first, end, airline,
+                                          [](int id, const AirlineEdge &e) { return id < e.airline; });
+    return {first, last};
+}
+
+/**
+ * Variant of shortest_path_bfs that walks the airline index, expanding each node only through the edges flown by
+ * the valid airlines instead of intersecting the airlines of every edge
+ * Time Complexity: O(|V| + n * |V| * log(d) + F'), where n is the size of validAirlines, d the largest number of index
+ * entries of a node and F' the number of flights of the valid airlines
+ * @param source - Index of the source node
+ * @param destination - Index of the destination node
+ * @param validAirlines - unordered_set of Airlines that are valid
+ * @return A list of pair<airlineTable, string>, each representing the airlines that connected the previous pair to this one, and the code of the connected Airport
+ */
+list<pair<airlineTable, string>>
+Graph::shortestPathAirlineView(const list<int> &source, int destination, const airlineTable &validAirlines) const {
+    ScopedMeasurement measurement(Operation::SHORTEST_PATH_BFS);
+    ScratchScope scratch;
+    pmr::vector<int> allowed(scratch.resource());
+    for (const Airline &airline: validAirlines) {
+        int id = findAirlineId(airline.getCode());
+        if (id != -1) allowed.push_back(id);
+    }
+    sort(allowed.begin(), allowed.end());
+
+    pmr::vector<int> parent(n + 1, -1, scratch.resource()); // Node each node was reached from, 0 for the sources
+    pmr::vector<pmr::vector<int>> hopAirlines(n + 1, scratch.resource()); // Valid airlines from the parent to each node
+    queue<int, pmr::deque<int>> q(scratch.resource());
+    for (int i: source) {
+        q.push(i);
+        parent[i] = 0;
+    }
+
+    while (!q.empty() && parent[destination] == -1) {
+        int u = q.front();
+        q.pop();
+        measurement.nodeExpanded();
+        for (int airline: allowed) {
+            auto range = airlineEdgesOf(u, airline);
+            for (const AirlineEdge *e = range.first; e != range.second; e++) {
+                measurement.edgeScanned();
+                int w = e->dest;
+                if (parent[w] == -1) {
+                    parent[w] = u;
+                    q.push(w);
+                }
+                if (parent[w] == u) hopAirlines[w].push_back(airline);
+            }
+        }
+    }
+    if (parent[destination] == -1) return {};
+
+    list<pair<airlineTable, string>> path;
+    for (int v = destination; v != 0; v = parent[v]) {
+        airlineTable hop;
+        for (int airline: hopAirlines[v]) hop.insert(indexedAirlines[airline]);
+        path.push_front({hop, nodes[v].airport.getCode()});
+    }
+    return path;
 }
 
 /**
@@ -159,7 +482,7 @@ Graph::shortest_path_bfs(list<int> source, int destination, airlineTable validAi
  */
 unsigned Graph::numAirlines(const Airport &airport) const {
     airlineTable currentAirlines;
-    int v = airportToNode.at(airport);
+    int v = findAirportNode(airport.getCode());
     for (Edge e: nodes[v].adj) {
         currentAirlines.merge(e.airlines);
     }
@@ -167,19 +490,25 @@ unsigned Graph::numAirlines(const Airport &airport) const {
 }
 
 /**
- * Computes the number of cities reachable in a flight from a given Airport
- * Time Complexity: O(outdegree(v) * N) (worst case) | O(outdegree(v)) (average case), where N is the number of different cities directly reachable from the given Airport and v is the node associated with the given Airport
+ * Computes the number of cities reachable in a flight from a given Airport, marking the city ids of the destinations
+ * (see setNodeCities) in the scratch arena
+ * Time Complexity: O(outdegree(v)), where v is the node associated with the given Airport
  * @param airport - Airport whose number of destinations should be calculated
  * @return Number of different cities reachable in direct flights from the given Airport
  */
 unsigned Graph::numDestinations(const Airport &airport) const {
-    cityTable currentCities;
-    int v = airportToNode.at(airport);
+    ScratchScope scratch;
+    pmr::vector<bool> seen(numCities, false, scratch.resource());
+    unsigned total = 0;
+    int v = findAirportNode(airport.getCode());
     for (const Edge &e: nodes[v].adj) {
-        int w = e.dest;
-        currentCities.insert({nodes[w].airport.getCity(), nodes[w].airport.getCountry()});
+        uint32_t city = nodes[e.dest].city;
+        if (city != NO_CITY && !seen[city]) {
+            seen[city] = true;
+            total++;
+        }
     }
-    return currentCities.size();
+    return total;
 }
 
 /**
@@ -190,7 +519,7 @@ unsigned Graph::numDestinations(const Airport &airport) const {
  */
 unsigned Graph::numCountries(const Airport &airport) const {
     unordered_set<string> currentCountries;
-    int v = airportToNode.at(airport);
+    int v = findAirportNode(airport.getCode());
     for (const Edge &e: nodes[v].adj) {
         int w = e.dest;
         currentCountries.insert(nodes[w].airport.getCountry());
@@ -217,33 +546,47 @@ airlineTable Graph::intersectTables(const airlineTable &table1, const airlineTab
 }
 
 /**
- * BFS function that visits the graph and sets the distance variable for all nodes
+ * Checks if two unordered_set<Airline> have an Airline in common, without building their intersection
+ * Time Complexity: O(n * m) (worst case) | O(n) (average case), where n is the size of the smaller table and m the size of the larger table
+ * @param table1 - First table
+ * @param table2 - Second table
+ * @return true if some Airline is in both tables, false otherwise
+ */
+bool Graph::hasCommonAirline(const airlineTable &table1, const airlineTable &table2) {
+    const airlineTable &smaller = table1.size() <= table2.size() ? table1 : table2;
+    const airlineTable &larger = table1.size() <= table2.size() ? table2 : table1;
+    for (const Airline &airline: smaller) {
+        if (larger.find(airline) != larger.end()) return true;
+    }
+    return false;
+}
+
+/**
+ * BFS function that visits the graph and computes the distance from the root to every node
  * Time Complexity: O(|V| +|E|)
  * @param v - Root node of the BFS
+ * @return vector with the number of flights from the root to each node, or -1 for unreachable nodes
  */
-void Graph::bfsDistance(int v) {
-    for (int i = 1; i <= n; i++) {
-        nodes[i].visited = false;
-        nodes[i].dist = -1;
-    }
+vector<int> Graph::bfsDistance(int v) const {
+    ScopedMeasurement measurement(Operation::BFS_DISTANCE);
+    vector<int> dist(n + 1, -1);
     queue<int> q; // queue of unvisited nodes
     q.push(v);
-    nodes[v].visited = true;
-    nodes[v].dist = 0;
+    dist[v] = 0;
     while (!q.empty()) { // while there are still unvisited nodes
         int u = q.front();
         q.pop();
-        // show node order
-        //cout << u << " ";
-        for (auto e: nodes[u].adj) {
+        measurement.nodeExpanded();
+        for (const Edge &e: nodes[u].adj) {
+            measurement.edgeScanned();
             int w = e.dest;
-            if (!nodes[w].visited) {
+            if (dist[w] == -1) {
                 q.push(w);
-                nodes[w].visited = true;
-                nodes[w].dist = nodes[u].dist + 1;
+                dist[w] = dist[u] + 1;
             }
         }
     }
+    return dist;
 }
 
 /**
@@ -253,32 +596,38 @@ void Graph::bfsDistance(int v) {
  * @param numFlights - Max number of flights
  * @return Number of airports reachable from the given Airport in less or numFlights flights
  */
-unsigned Graph::numAirportsInXFlights(const Airport &airport, unsigned numFlights) {
+unsigned Graph::numAirportsInXFlights(const Airport &airport, unsigned numFlights) const {
     unsigned total = 0;
-    int v = airportToNode.at(airport);
-    bfsDistance(v);
+    int v = findAirportNode(airport.getCode());
+    vector<int> dist = bfsDistance(v);
     for (int i = 1; i <= n; i++) {
-        if (nodes[i].dist <= numFlights) total++;
+        if (dist[i] != -1 && dist[i] <= (int) numFlights) total++;
     }
     return total - 1; //Excluding the airport itself
 }
 
 /**
- * Computes the number of cities reachable from the given Airport in less than x flights
- * Time Complexity: O(|V|²) (worst case) | O(|V| + |E|) (average case)
+ * Computes the number of cities reachable from the given Airport in less than x flights, marking their city ids (see
+ * setNodeCities) in the scratch arena
+ * Time Complexity: O(|V| + |E|)
  * @param airport - Source Airport
  * @param numFlights - Max number of flights
  * @return Number of cities reachable from the given Airport in less or numFlights flights
  */
-unsigned Graph::numCitiesInXFlights(const Airport &airport, unsigned numFlights) {
-    cityTable currentCities;
-    int v = airportToNode.at(airport);
-    bfsDistance(v);
+unsigned Graph::numCitiesInXFlights(const Airport &airport, unsigned numFlights) const {
+    int v = findAirportNode(airport.getCode());
+    vector<int> dist = bfsDistance(v);
+    ScratchScope scratch;
+    pmr::vector<bool> seen(numCities, false, scratch.resource());
+    unsigned total = 0;
     for (int i = 1; i <= n; i++) {
-        if (nodes[i].dist <= numFlights)
-            currentCities.insert({nodes[i].airport.getCity(), nodes[i].airport.getCountry()});
+        uint32_t city = nodes[i].city;
+        if (dist[i] != -1 && dist[i] <= (int) numFlights && city != NO_CITY && !seen[city]) {
+            seen[city] = true;
+            total++;
+        }
     }
-    return currentCities.size() - 1; //Excluding the airport itself
+    return nodes[v].city != NO_CITY ? total - 1 : total; //Excluding the airport's own city
 }
 
 /**
@@ -288,107 +637,130 @@ unsigned Graph::numCitiesInXFlights(const Airport &airport, unsigned numFlights)
  * @param numFlights - Max number of flights
  * @return Number of countries reachable from the given Airport in less or numFlights flights
  */
-unsigned Graph::numCountriesInXFlights(const Airport &airport, unsigned numFlights) {
+unsigned Graph::numCountriesInXFlights(const Airport &airport, unsigned numFlights) const {
     unordered_set<string> currentCountries;
-    int v = airportToNode.at(airport);
-    bfsDistance(v);
+    int v = findAirportNode(airport.getCode());
+    vector<int> dist = bfsDistance(v);
     for (int i = 1; i <= n; i++) {
-        if (nodes[i].dist <= numFlights) currentCountries.insert(nodes[i].airport.getCountry());
+        if (dist[i] != -1 && dist[i] <= (int) numFlights) currentCountries.insert(nodes[i].airport.getCountry());
     }
     return currentCountries.size() - 1; //Excluding the airport itself
 }
 
 /**
- * Basic BFS algorithm adapted to register the distance from the starting node in its atributes
+ * Basic BFS algorithm adapted to compute the largest distance from the starting node
  * Time Complexity: O(|V+E|)
  * @param v - Index of the node node from where the search begins
+ * @return Largest number of flights needed to reach a node reachable from v
  */
-int Graph::bfsMaxDistance(int v) {
-    for (int i = 1; i <= n; i++) {
-        nodes[i].visited = false;
-        nodes[i].dist = -1;
-    }
-    int maxDistance = 0;
-    queue<int> q; // queue of unvisited nodes
-    q.push(v);
-    nodes[v].visited = true;
-    nodes[v].dist = 0;
-    while (!q.empty()) { // while there are still unvisited nodes
-        int u = q.front();
-        q.pop();
-        // show node order
-        //cout << u << " ";
-        for (auto e: nodes[u].adj) {
-            int w = e.dest;
-            if (!nodes[w].visited) {
-                q.push(w);
-                nodes[w].visited = true;
-                nodes[w].dist = nodes[u].dist + 1;
-                if (nodes[w].dist > maxDistance) maxDistance = nodes[w].dist;
+int Graph::bfsMaxDistance(int v) const {
+    vector<int> dist = bfsDistance(v);
+    return *max_element(dist.begin(), dist.end());
+}
+
+/**
+ * Calculates the diameter of the graph composed by the airports
+ * Time Complexity: O(|V|(|V+E|)), split across one thread per hardware thread
+ */
+int Graph::getDiameter() const {
+    vector<int> eccentricity = eccentricities();
+    return n == 0 ? -1 : *max_element(eccentricity.begin() + 1, eccentricity.end());
+}
+
+/**
+ * Computes the eccentricity of every node of a CSR export with one BFS per node, spreading the searches across worker
+ * threads that reuse their search vectors
+ * Time Complexity: O(|V|(|V+E|)), split across the threads
+ * @param csr - Export of the graph
+ * @param numThreads - Number of worker threads, or 0 for one per hardware thread
+ * @return vector with the eccentricity of each node (index 0 is unused)
+ */
+template<typename Csr>
+static vector<int> csrEccentricities(const Csr &csr, unsigned numThreads) {
+    typedef typename Csr::node_type NodeId;
+    typedef typename Csr::distance_type Distance;
+    vector<int> eccentricity(csr.n + 1, 0);
+    ThreadPool pool(numThreads);
+    vector<vector<Distance>> dist(pool.size(), vector<Distance>(csr.n + 1, Csr::UNREACHABLE));
+    vector<vector<NodeId>> order(pool.size());
+    pool.parallelFor(csr.n, [&](unsigned item, unsigned slot) {
+        ScopedMeasurement measurement(Operation::BFS_DISTANCE);
+        int v = (int) item + 1;
+        vector<Distance> &d = dist[slot];
+        vector<NodeId> &q = order[slot];
+        q.assign(1, (NodeId) v);
+        d[v] = 0;
+        for (size_t head = 0; head < q.size(); head++) {
+            NodeId u = q[head];
+            Distance next = d[u] < Csr::UNREACHABLE - 1 ? (Distance) (d[u] + 1) : d[u]; // Saturated, see caller
+            measurement.nodeExpanded();
+            for (int i = csr.offsets[u]; i < csr.offsets[u + 1]; i++) {
+                measurement.edgeScanned();
+                NodeId w = csr.targets[i];
+                if (d[w] == Csr::UNREACHABLE) {
+                    d[w] = next;
+                    q.push_back(w);
+                }
             }
         }
-    }
-    return maxDistance;
+        eccentricity[v] = d[q.back()];
+        for (NodeId u: q) d[u] = Csr::UNREACHABLE;
+    });
+    return eccentricity;
 }
 
 /**
- * Calculates the diameter of the graph composed by the airports
- * Time Complexity: O(|V|(|V+E|))
+ * Computes the eccentricity of every airport (the largest number of flights needed to reach an airport reachable from
+ * it) with one BFS per airport over a CSR export of the graph. Networks of up to 65535 airports use 16 bit ids and
+ * 8 bit distances, falling back to int ones if some airport turns out to be too far.
+ * Time Complexity: O(|V|(|V+E|)), split across the threads
+ * @param numThreads - Number of worker threads, or 0 for one per hardware thread
+ * @return vector with the eccentricity of each node (index 0 is unused)
  */
-int Graph::getDiameter() {
-    int maxDistance = -1;
-    for (int i = 1; i <= n; i++) {
-        int currentDistance = bfsMaxDistance(i);
-        if(currentDistance > maxDistance) maxDistance = currentDistance;
+vector<int> Graph::eccentricities(unsigned numThreads) const {
+    if (HopCsrGraph::fits(*this)) {
+        vector<int> eccentricity = csrEccentricities(HopCsrGraph::fromGraph(*this), numThreads);
+        if (n == 0 || *max_element(eccentricity.begin() + 1, eccentricity.end()) < HopCsrGraph::UNREACHABLE - 1) {
+            return eccentricity;
+        }
     }
-    return maxDistance;
+    return csrEccentricities(BasicCsrGraph<int, int, NoAirlines>::fromGraph(*this), numThreads);
 }
 
 /**
- * Computes the amount of flights that exist, ignoring their airlines.
- * Time Complexity: O(|V|)
+ * Returns the amount of flights that exist, ignoring their airlines.
+ * Time Complexity: O(1)
  * @return Number of total flights
  */
 int Graph::getTotalFlightsAirlineless() const{
-    int nFlights = 0;
-    for (int i = 1; i <= n; i++){
-        nFlights += nodes[i].adj.size();
-    }
-    return nFlights;
+    return totalFlightsAirlineless;
 }
 
 /**
- * Computes the amount of unique flights that exist, considering the airlines.
- * Time Complexity: O(|V*E|)
+ * Returns the amount of unique flights that exist, considering the airlines.
+ * Time Complexity: O(1)
  * @return Number of total flights
  */
-
 int Graph::getTotalFlights() const{
-    int nFlights = 0;
-    for (int i = 1; i<= n; i++){
-        for (Edge e : nodes[i].adj) nFlights += e.airlines.size();
-    }
-    return nFlights;
+    return totalFlights;
 }
 
 
 /**
  * Computes a list of the shortest paths (not exhaustive) connecting the source airports to the target airports, using only airlines in validAirlines
  * Time Complexity: O(|V|+|E| * n * m * k) (worst case) | O(|V|+|E| * n * k) (average case), where n is the size of validAirlines, m is the largest number of airlines on an Edge, and k the size of target
- * @param source - List of source Airports
- * @param target - List of target Airports
+ * @param source - Indexes of the source nodes
+ * @param target - Indexes of the target nodes
  * @param validAirlines - unordered_set of Airlines that are valid
  * @return A list of the shortest paths, where paths are a list of pair<airlineTable, string>, each representing the airlines that connected the previous pair to this one, and the code of the connected Airport
  */
 list<list<pair<airlineTable, string>>>
-Graph::getShortestPath(const list<Airport> &source, const list<Airport> &target, airlineTable validAirlines) {
-    list<int> listSource, listDest;
+Graph::getShortestPath(const list<int> &source, const list<int> &target, const airlineTable &validAirlines) const {
     list<list<pair<airlineTable, string>>> shortestPaths;
 
-    for (const Airport &airport: source) { listSource.push_back(airportToNode[airport]); }
-
-    for (const Airport &airport: target) {
-        auto currentPath = shortest_path_bfs(listSource, airportToNode[airport], validAirlines);
+    for (int destination: target) {
+        auto currentPath = shortest_path_bfs(source, destination, validAirlines);
+        if (currentPath.empty()) continue; // Unreachable target
         if (shortestPaths.size() == 0 || currentPath.size() == shortestPaths.front().size())
             shortestPaths.push_back(currentPath);
         else if (currentPath.size() < shortestPaths.front().size()) shortestPaths = {currentPath};
@@ -397,60 +769,304 @@ Graph::getShortestPath(const list<Airport> &source, const list<Airport> &target,
 }
 
 
+/**
+ * Finds a route from one of the source nodes to one of the target nodes that changes airline the fewest times,
+ * breaking ties by the number of flights, flying only valid airlines. Searches the implicit graph of (airport, airline
+ * of the last flight) states, expanded lazily from the airline index: taking a flight of the same airline costs no
+ * change, any other airline costs one (the first flight is free). As in a 0-1 BFS, states are settled one number of
+ * changes at a time; within each level, the states reached with a change and those reached without one are both
+ * produced in increasing number of flights, so merging the two queues settles them in (changes, flights) order.
+ * Needs an up to date airline index (see buildAirlineIndex).
+ * Time Complexity: O(|V| + F), where F is the number of flights
+ * @param source - Indexes of the source nodes
+ * @param target - Indexes of the target nodes; targets that are also sources are ignored
+ * @param validAirlines - unordered_set of Airlines that are valid
+ * @return The route, as a list of pair<airlineTable, string>, each holding the airline of the flight that reached the
+ * Airport and its code, or an empty list if no target is reachable or the airline index is stale
+ */
+list<pair<airlineTable, string>>
+Graph::fewest_changes_bfs(const list<int> &source, const list<int> &target, const airlineTable &validAirlines) const {
+    if (!hasAirlineIndex()) return {};
+    ScopedMeasurement measurement(Operation::SHORTEST_PATH_BFS);
+    ScratchScope scratch;
+    pmr::vector<bool> allowed(indexedAirlines.size(), false, scratch.resource());
+    pmr::vector<bool> isTarget(n + 1, false, scratch.resource());
+    for (const Airline &airline: validAirlines) {
+        int id = findAirlineId(airline.getCode());
+        if (id != -1) allowed[id] = true;
+    }
+    for (int v: target) isTarget[v] = true;
+    for (int v: source) isTarget[v] = false;
+
+    struct Label {
+        int node, airline, flights, parent; // airline is -1 at the sources, parent is an index into labels
+        int state; // Arrival state (see arrivalStates), or numArrivalStates + node at the sources
+    };
+    pmr::vector<Label> labels(scratch.resource());
+    pmr::vector<pair<int, int>> best(numArrivalStates + n + 1, {INT_MAX, INT_MAX}, // Fewest (changes, flights) per state
+                                     scratch.resource());
+    auto improves = [&best](int state, int changes, int flights) {
+        if (best[state] <= make_pair(changes, flights)) return false;
+        best[state] = {changes, flights};
+        return true;
+    };
+
+    // Labels of the current level, sorted by flights
+    pmr::vector<int> changed(scratch.resource()), sameAirline(scratch.resource()), nextChanged(scratch.resource());
+    for (int v: source) {
+        if (!improves(numArrivalStates + v, 0, 0)) continue;
+        changed.push_back((int) labels.size());
+        labels.push_back({v, -1, 0, -1, numArrivalStates + v});
+    }
+
+    int found = -1;
+    for (int changes = 0; found == -1 && !changed.empty(); changes++) {
+        sameAirline.clear();
+        nextChanged.clear();
+        size_t changedPos = 0, samePos = 0;
+        while (changedPos < changed.size() || samePos < sameAirline.size()) {
+            bool takeChanged = samePos == sameAirline.size() || (changedPos < changed.size() &&
+                               labels[changed[changedPos]].flights <= labels[sameAirline[samePos]].flights);
+            int current = takeChanged ? changed[changedPos++] : sameAirline[samePos++];
+            Label label = labels[current];
+            if (best[label.state] != make_pair(changes, label.flights)) continue; // Stale
+            if (isTarget[label.node]) {
+                found = current;
+                break;
+            }
+            measurement.nodeExpanded();
+            for (int i = airlineEdgeOffsets[label.node]; i < airlineEdgeOffsets[label.node + 1]; i++) {
+                measurement.edgeScanned();
+                const AirlineEdge &e = airlineEdges[i];
+                if (!allowed[e.airline]) continue;
+                bool change = label.airline != -1 && e.airline != label.airline;
+                if (!improves(arrivalStates[i], changes + change, label.flights + 1)) continue;
+                (change ? nextChanged : sameAirline).push_back((int) labels.size());
+                labels.push_back({e.dest, e.airline, label.flights + 1, current, arrivalStates[i]});
+            }
+        }
+        changed.swap(nextChanged);
+    }
+    if (found == -1) return {};
+
+    list<pair<airlineTable, string>> path;
+    for (int current = found; current != -1; current = labels[current].parent) {
+        const Label &label = labels[current];
+        airlineTable hop;
+        if (label.airline != -1) hop.insert(indexedAirlines[label.airline]);
+        path.push_front({hop, nodes[label.node].airport.getCode()});
+    }
+    return path;
+}
+
+/**
+ * Computes the route connecting the source airports to the target airports with the fewest airline changes (and,
+ * among those, the fewest flights), using only airlines in validAirlines
+ * Time Complexity: that of fewest_changes_bfs
+ * @param source - Indexes of the source nodes
+ * @param target - Indexes of the target nodes
+ * @param validAirlines - unordered_set of Airlines that are valid
+ * @return A list holding the route, or an empty list if there is none, in the format of getShortestPath
+ */
+list<list<pair<airlineTable, string>>>
+Graph::getFewestChangesPath(const list<int> &source, const list<int> &target,
+                            const airlineTable &validAirlines) const {
+    auto path = fewest_changes_bfs(source, target, validAirlines);
+    if (path.empty()) return {};
+    return {path};
+}
+
+/**
+ * Finds the Pareto-optimal routes from the source nodes to the target nodes under three criteria: number of flights,
+ * total flown distance and number of airline changes, flying only valid airlines. Label-setting search (Martins'
+ * algorithm): each airport keeps a bag of partial routes (labels) no other label dominates, and labels are settled in
+ * lexicographic (flights, distance, changes) order, which never lets a later label dominate a settled one. A label
+ * arriving by another airline than a competitor's is only dominated if it is worse by at least one change, since the
+ * competitor could need a change to continue where it can't (except at the targets, where routes end). Labels
+ * dominated by a route already reaching a target are pruned. Bags hold at most maxLabelsPerAirport labels, so on very
+ * dense networks some trade-offs may be missed.
+ * Needs an up to date airline index (see buildAirlineIndex).
+ * Time Complexity: O(F * b * (b + t + log(F * b))), where F is the number of flights of the valid airlines, b the
+ * bag bound and t the number of Pareto-optimal routes
+ * @param source - Indexes of the source nodes
+ * @param target - Indexes of the target nodes; targets that are also sources are ignored
+ * @param validAirlines - unordered_set of Airlines that are valid
+ * @param maxLabelsPerAirport - Most labels kept at each airport
+ * @return The Pareto-optimal routes, by increasing number of flights, in the format of fewest_changes_bfs
+ */
+list<list<pair<airlineTable, string>>>
+Graph::pareto_search(const list<int> &source, const list<int> &target, const airlineTable &validAirlines,
+                     unsigned maxLabelsPerAirport) const {
+    if (!hasAirlineIndex()) return {};
+    ScopedMeasurement measurement(Operation::SHORTEST_PATH_BFS);
+    ScratchScope scratch;
+    pmr::vector<bool> allowed(indexedAirlines.size(), false, scratch.resource());
+    pmr::vector<bool> isTarget(n + 1, false, scratch.resource());
+    for (const Airline &airline: validAirlines) {
+        int id = findAirlineId(airline.getCode());
+        if (id != -1) allowed[id] = true;
+    }
+    for (int v: target) isTarget[v] = true;
+    for (int v: source) isTarget[v] = false;
+
+    struct Label {
+        int node, airline, flights, changes, parent; // airline is -1 at the sources, parent is an index into labels
+        double distance;
+        bool alive; // Whether the label is still in its airport's bag
+    };
+    auto dominates = [&isTarget](const Label &a, const Label &b) {
+        int extraChange = a.airline != -1 && a.airline != b.airline && !isTarget[a.node]; // Routes end at targets
+        return a.flights <= b.flights && a.distance <= b.distance && a.changes + extraChange <= b.changes;
+    };
+    pmr::vector<Label> labels(scratch.resource());
+    pmr::vector<pmr::vector<int>> bags(n + 1, scratch.resource());
+    pmr::vector<int> reached(scratch.resource()); // Labels settled at a target
+    typedef tuple<int, double, int, int> queueEntry; // flights, distance, changes, label
+    priority_queue<queueEntry, pmr::vector<queueEntry>, greater<queueEntry>> pq(
+            greater<queueEntry>(), pmr::vector<queueEntry>(scratch.resource()));
+
+    auto insert = [&](const Label &label) {
+        for (int t: reached) {
+            const Label &other = labels[t];
+            if (other.flights <= label.flights && other.distance <= label.distance && other.changes <= label.changes)
+                return;
+        }
+        pmr::vector<int> &bag = bags[label.node];
+        for (int i: bag) {
+            if (dominates(labels[i], label)) return;
+        }
+        for (size_t i = 0; i < bag.size();) {
+            if (dominates(label, labels[bag[i]])) {
+                labels[bag[i]].alive = false;
+                bag[i] = bag.back();
+                bag.pop_back();
+            } else i++;
+        }
+        if (bag.size() >= maxLabelsPerAirport) return;
+        bag.push_back((int) labels.size());
+        pq.emplace(label.flights, label.distance, label.changes, (int) labels.size());
+        labels.push_back(label);
+    };
+    for (int v: source) insert({v, -1, 0, 0, -1, 0, true});
+
+    while (!pq.empty()) {
+        int current = get<3>(pq.top());
+        pq.pop();
+        Label label = labels[current];
+        if (!label.alive) continue;
+        if (isTarget[label.node]) {
+            reached.push_back(current);
+            continue;
+        }
+        measurement.nodeExpanded();
+        const Position &from = nodes[label.node].airport.getLocation();
+        for (int i = airlineEdgeOffsets[label.node]; i < airlineEdgeOffsets[label.node + 1]; i++) {
+            measurement.edgeScanned();
+            const AirlineEdge &e = airlineEdges[i];
+            if (!allowed[e.airline]) continue;
+            int change = label.airline != -1 && e.airline != label.airline;
+            insert({e.dest, e.airline, label.flights + 1, label.changes + change, current,
+                    label.distance + from.getDistance(nodes[e.dest].airport.getLocation()), true});
+        }
+    }
+
+    list<list<pair<airlineTable, string>>> paths;
+    for (int found: reached) {
+        list<pair<airlineTable, string>> path;
+        for (int current = found; current != -1; current = labels[current].parent) {
+            airlineTable hop;
+            if (labels[current].airline != -1) hop.insert(indexedAirlines[labels[current].airline]);
+            path.push_front({hop, nodes[labels[current].node].airport.getCode()});
+        }
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+/**
+ * Computes the Pareto-optimal routes (fewest flights, shortest distance, fewest airline changes) connecting the source
+ * airports to the target airports, using only airlines in validAirlines
+ * Time Complexity: that of pareto_search
+ * @param source - Indexes of the source nodes
+ * @param target - Indexes of the target nodes
+ * @param validAirlines - unordered_set of Airlines that are valid
+ * @param maxLabelsPerAirport - Most partial routes kept at each airport
+ * @return The Pareto-optimal routes, by increasing number of flights, in the format of getShortestPath
+ */
+list<list<pair<airlineTable, string>>>
+Graph::getParetoPaths(const list<int> &source, const list<int> &target, const airlineTable &validAirlines,
+                      unsigned maxLabelsPerAirport) const {
+    return pareto_search(source, target, validAirlines, maxLabelsPerAirport);
+}
+
 /**
  * Depth-First Search Algorithm variation that returns the ammounts of strongly connected components starting on a certain airport
  * Time Complexity: O(|V+E|)
  * @param v - Index of the airport where the search beggings
+ * @param state - Tarjan's algorithm state shared by the searches of countSCCs
  */
-int Graph::dfs_scc(int v){
-    nodes[v].num = this -> idx;
-    nodes[v].low = this -> idx;
-    this->idx++;
-    stack.push_back(v);
+int Graph::dfs_scc(int v, TarjanState &state) const {
+    state.num[v] = state.idx;
+    state.low[v] = state.idx;
+    state.idx++;
+    state.stack.push_back(v);
+    state.onStack[v] = true;
+    state.measurement.nodeExpanded();
     int acc = 0;
 
-    for (Edge e : nodes[v].adj){
+    for (const Edge &e : nodes[v].adj){
+        state.measurement.edgeScanned();
         int w = e.dest;
-        if (nodes[w].num == -1){
-            dfs_scc(w);
-            if (nodes[w].low < nodes[v].low) nodes[v].low = nodes[w].low;
+        if (state.num[w] == -1){
+            acc += dfs_scc(w, state);
+            if (state.low[w] < state.low[v]) state.low[v] = state.low[w];
         }
-        else if (find(stack.begin(), stack.end(),w)!=stack.end()){
-            if (nodes[w].num < nodes[v].low) nodes[v].low = nodes[w].num;
+        else if (state.onStack[w]){
+            if (state.num[w] < state.low[v]) state.low[v] = state.num[w];
         }
     }
 
-    if (nodes[v].num == nodes[v].low){
+    if (state.num[v] == state.low[v]){
         acc++;
         int w;
         do{
-            w = stack.back();
-            stack.pop_back();
+            w = state.stack.back();
+            state.stack.pop_back();
+            state.onStack[w] = false;
+            state.component[w] = state.numComponents;
         } while (w != v);
+        state.numComponents++;
     }
     return acc;
 }
 
 /**
  * Computes how many Strongly Connected Components are in the graph composed by the airports
- * Time Complexity: O(|V|*|V+E|)
+ * Time Complexity: O(|V+E|)
  */
-int Graph::countSCCs(){
-    this-> idx = 1;
-    vector<int> temp;
-    this->stack = temp;
+int Graph::countSCCs() const {
+    TarjanState state{vector<int>(n + 1, -1), vector<int>(n + 1, -1), vector<bool>(n + 1, false), {}, 1,
+                      vector<int>(n + 1, -1)};
     int acc = 0;
 
     for (int i = 1; i <= n; i++){
-        nodes[i].num = -1;
-        nodes[i].low = -1;
-        nodes[i].visited = false;
-    }
-
-    for (int i = 1; i <= n; i++){
-        if (nodes[i].num == -1){
-            acc += dfs_scc(i);
+        if (state.num[i] == -1){
+            acc += dfs_scc(i, state);
         }
     }
     return acc;
 }
+
+/**
+ * Labels every airport with the Strongly Connected Component it belongs to
+ * Time Complexity: O(|V+E|)
+ * @return vector with the component of each node, numbered from 0 (index 0 is unused)
+ */
+vector<int> Graph::sccComponents() const {
+    TarjanState state{vector<int>(n + 1, -1), vector<int>(n + 1, -1), vector<bool>(n + 1, false), {}, 1,
+                      vector<int>(n + 1, -1)};
+    for (int i = 1; i <= n; i++) {
+        if (state.num[i] == -1) dfs_scc(i, state);
+    }
+    return state.component;
+}
@@ -2,44 +2,99 @@
 #define GRAPH_H_
 
 #include <list>
+#include <memory>
+#include <memory_resource>
 #include <vector>
 #include <queue>
 #include <iostream>
 #include <unordered_map>
 #include <stack>
 #include "airline.h"
+#include "arena.h"
+#include "codeMap.h"
 #include "airport.h"
 #include "dataRepository.h"
+#include "instrumentation.h"
 
 using namespace std;
 
+enum class NodeOrder {
+    LOAD, // Order the airports were added in
+    DEGREE, // Most connected airports first
+    RCM // Reverse Cuthill-McKee: breadth-first, so airports close in the network get close indexes
+};
+
 class Graph {
     struct Edge {
         int dest;   // Destination node
         airlineTable airlines; // The airlines whose flights connect the two nodes
     };
 
+    static const uint32_t NO_CITY = UINT32_MAX; // City of the nodes setNodeCities hasn't numbered
+
     struct Node {
         Airport airport; //The Airport this node represents
-        list<Edge> adj; // The list of outgoing edges (to adjacent nodes)
-        bool visited;   // As the node been visited on a search?
-        list<pair<airlineTable, string>> predecessing_trip; // The node that connected to this node
-        int dist;
-        int num;
-        int low;
+        pmr::list<Edge> adj; // The list of outgoing edges (to adjacent nodes), allocated from the graph's edge arena
+        uint32_t city = NO_CITY; // Id of the city of the Airport in the repository's city index, see setNodeCities
+    };
+
+    struct TarjanState {
+        vector<int> num;
+        vector<int> low;
+        vector<bool> onStack;
+        vector<int> stack;
+        int idx;
+        vector<int> component; // Strongly connected component of each visited node, numbered from 0
+        int numComponents = 0;
+        ScopedMeasurement measurement{Operation::DFS_SCC};
     };
 
+public:
+    struct AirlineEdge {
+        int airline; // Id of the airline flying this leg, see findAirlineId
+        int dest;    // Destination node
+    };
+
+private:
+
     int n;              // Graph size (vertices are numbered from 1 to n)
+    // Arena holding the edge lists and their airlineTables, released as a whole with the graph
+    unique_ptr<Arena> edgeArena;
     vector<Node> nodes; // The list of nodes being represented
-    airportMap<int> airportToNode;
+    CodeMap<int> codeToNode; // Node of each airport code
     airlineTable airlines;
-    vector<int> stack; // stack as vector (so we can use the find() algorithm)
-    int idx;
+    int totalFlights = 0; // Number of (source, target, airline) flights, kept up to date by addEdge
+    int totalFlightsAirlineless = 0; // Number of edges, kept up to date by addEdge
+    unsigned numCities = 0; // Number of cities of the city index the nodes were numbered from
+    unsigned long long version = 0; // Incremented on every change, so results computed from the graph can detect they are stale
+
+    // Airline index: the edges of every node, one entry per airline, sorted by (airline, dest)
+    vector<Airline> indexedAirlines; // Airline of each airline id, sorted by code
+    CodeMap<int> airlineIds; // Airline code to airline id
+    vector<int> airlineEdgeOffsets; // Edges of node v are airlineEdges[airlineEdgeOffsets[v] .. airlineEdgeOffsets[v+1])
+    vector<AirlineEdge> airlineEdges;
+    vector<int> arrivalStates; // Id of the (dest, airline) pair of each entry of airlineEdges, numbered from 0
+    int numArrivalStates = 0;
+    unsigned long long airlineIndexVersion = ~0ULL; // Version of the graph the index was built from
+
+    list<pair<airlineTable, string>>
+    shortestPathAirlineView(const list<int> &source, int destination, const airlineTable &validAirlines) const;
 
 public:
+    // Largest airline restriction answered through the airline index instead of the full adjacency
+    static const unsigned MAX_AIRLINE_VIEW_SIZE = 8;
+
+    // Default bound on the routes pareto_search keeps at each airport
+    static const unsigned MAX_PARETO_LABELS = 16;
+
     // Constructor: nr nodes and direction (default: undirected)
     explicit Graph(int nodes);
 
+    // The edge lists of nodes point into edgeArena, so assigning a graph would free the old arena before the old lists
+    Graph &operator=(const Graph &) = delete;
+
+    Graph &operator=(Graph &&) = delete;
+
     // Add edge from source to destination with a certain weight
     void addEdge(int src, int dest, const airlineTable &connectingAirlines);
 
@@ -47,10 +102,14 @@ public:
 
     void addNode(const Airport &airport);
 
-    int dfs_scc(int v);
-    int bfsMaxDistance(int v);
+    void setNodeCities(const DataRepository &dataRepository);
+
+    int dfs_scc(int v, TarjanState &state) const;
+    int bfsMaxDistance(int v) const;
 
     int getN() const;
+
+    unsigned long long getVersion() const;
     int getTotalFlightsAirlineless() const; //total voos ignorando companhias
     int getTotalFlights() const; // total de voos únicos
 
@@ -58,11 +117,11 @@ public:
 
     const vector<Node> &getNodes() const;
 
-    void setNodes(const vector<Node> &nodes);
+    const Arena &getEdgeArena() const;
 
-    const airportMap<int> &getAirportToNode() const;
+    void setNodes(const vector<Node> &nodes);
 
-    void setAirportToNode(const airportMap<int> &airportToNode);
+    const CodeMap<int> &getCodeToNode() const;
 
     const airlineTable &getAirlines() const;
 
@@ -70,11 +129,15 @@ public:
 
     unsigned numFlights(const Airport &airport) const;
 
-    int countSCCs();
+    int countSCCs() const;
+
+    vector<int> sccComponents() const;
     
-    int getDiameter();
+    int getDiameter() const;
 
-    int findAirportNode(const string &code);
+    vector<int> eccentricities(unsigned numThreads = 0) const;
+
+    int findAirportNode(const string &code) const;
 
     unsigned int numAirlines(const Airport &airport) const;
 
@@ -82,20 +145,55 @@ public:
 
     unsigned int numCountries(const Airport &airport) const;
 
-    airlineTable intersectTables(const airlineTable &table1, const airlineTable &table2);
+    static airlineTable intersectTables(const airlineTable &table1, const airlineTable &table2);
+
+    static bool hasCommonAirline(const airlineTable &table1, const airlineTable &table2);
+
+    vector<int> bfsDistance(int v) const;
+
+    unsigned int numAirportsInXFlights(const Airport &airport, unsigned int numFlights) const;
+
+    unsigned int numCitiesInXFlights(const Airport &airport, unsigned numFlights) const;
+
+    unsigned int numCountriesInXFlights(const Airport &airport, unsigned int numFlights) const;
+
+    void renumberNodes(const vector<int> &newIndex);
+
+    vector<int> computeNodeOrder(NodeOrder order) const;
+
+    void reorderNodes(NodeOrder order);
 
-    void bfsDistance(int v);
+    void buildAirlineIndex();
 
-    unsigned int numAirportsInXFlights(const Airport &airport, unsigned int numFlights);
+    bool hasAirlineIndex() const;
 
-    unsigned int numCitiesInXFlights(const Airport &airport, unsigned numFlights);
+    int getNumIndexedAirlines() const;
 
-    unsigned int numCountriesInXFlights(const Airport &airport, unsigned int numFlights);
+    const Airline &getIndexedAirline(int id) const;
 
-    list<pair<airlineTable, string>> shortest_path_bfs(list<int> source, int destination, airlineTable validAirlines);
+    int findAirlineId(const string &code) const;
+
+    pair<const AirlineEdge *, const AirlineEdge *> airlineEdgesOf(int v, int airline) const;
+
+    list<pair<airlineTable, string>>
+    shortest_path_bfs(const list<int> &source, int destination, const airlineTable &validAirlines) const;
+
+    list<list<pair<airlineTable, string>>>
+    getShortestPath(const list<int> &source, const list<int> &target, const airlineTable &validAirlines) const;
+
+    list<pair<airlineTable, string>>
+    fewest_changes_bfs(const list<int> &source, const list<int> &target, const airlineTable &validAirlines) const;
+
+    list<list<pair<airlineTable, string>>>
+    getFewestChangesPath(const list<int> &source, const list<int> &target, const airlineTable &validAirlines) const;
+
+    list<list<pair<airlineTable, string>>>
+    pareto_search(const list<int> &source, const list<int> &target, const airlineTable &validAirlines,
+                  unsigned maxLabelsPerAirport) const;
 
     list<list<pair<airlineTable, string>>>
-    getShortestPath(const list<Airport> &source, const list<Airport> &target, airlineTable validAirlines);
+    getParetoPaths(const list<int> &source, const list<int> &target, const airlineTable &validAirlines,
+                   unsigned maxLabelsPerAirport = MAX_PARETO_LABELS) const;
 };
 
 #endif
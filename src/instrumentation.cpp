@@ -0,0 +1,161 @@
+#include "instrumentation.h"
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+    struct OperationStats {
+        atomic<unsigned long long> calls{0};
+        atomic<unsigned long long> totalNanoseconds{0};
+        atomic<unsigned long long> maxNanoseconds{0};
+        atomic<unsigned long long> nodesExpanded{0};
+        atomic<unsigned long long> edgesScanned{0};
+        atomic<unsigned long long> airlineIntersections{0};
+        atomic<unsigned long long> buckets[Instrumentation::NUM_BUCKETS] = {};
+    };
+
+    OperationStats stats[(int) Operation::NUM_OPERATIONS];
+
+    /**
+     * Returns the histogram bucket of a duration: 0 for 0 ns, otherwise 1 + floor(log2(nanoseconds))
+     */
+    unsigned bucketOf(unsigned long long nanoseconds) {
+        unsigned bucket = 0;
+        while (nanoseconds > 0 && bucket < Instrumentation::NUM_BUCKETS - 1) {
+            nanoseconds >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+
+    /**
+     * Estimates a percentile of an operation's durations as the upper bound of the bucket it falls in, capped by the max
+     */
+    unsigned long long percentile(const OperationStats &operation, double fraction) {
+        unsigned long long calls = operation.calls.load(memory_order_relaxed), seen = 0;
+        unsigned long long maxNanoseconds = operation.maxNanoseconds.load(memory_order_relaxed);
+        for (unsigned i = 0; i < Instrumentation::NUM_BUCKETS; i++) {
+            seen += operation.buckets[i].load(memory_order_relaxed);
+            if (calls > 0 && seen >= fraction * calls) return i == 0 ? 0 : min(1ULL << i, maxNanoseconds);
+        }
+        return maxNanoseconds;
+    }
+}
+
+const char *Instrumentation::operationName(Operation operation) {
+    static const char *names[] = {"load_airlines", "load_airports", "load_flights", "shortest_path_bfs",
+                                  "bfs_distance", "dfs_scc", "geo_lookup", "airport_search", "query_parse",
+                                  "query_execute", "query_format"};
+    return names[(int) operation];
+}
+
+/**
+ * Adds a measurement to the totals and the latency histogram of an operation. Safe to call from several threads
+ * Time Complexity: O(log t), where t is the measured duration
+ * @param operation - Operation measured
+ * @param nanoseconds - Wall time it took
+ * @param nodesExpanded - Nodes taken from the search frontier
+ * @param edgesScanned - Edges looked at
+ * @param airlineIntersections - Airline set intersections performed
+ */
+void Instrumentation::record(Operation operation, unsigned long long nanoseconds, unsigned long long nodesExpanded,
+                             unsigned long long edgesScanned, unsigned long long airlineIntersections) {
+    OperationStats &s = stats[(int) operation];
+    s.calls.fetch_add(1, memory_order_relaxed);
+    s.totalNanoseconds.fetch_add(nanoseconds, memory_order_relaxed);
+    s.nodesExpanded.fetch_add(nodesExpanded, memory_order_relaxed);
+    s.edgesScanned.fetch_add(edgesScanned, memory_order_relaxed);
+    s.airlineIntersections.fetch_add(airlineIntersections, memory_order_relaxed);
+    s.buckets[bucketOf(nanoseconds)].fetch_add(1, memory_order_relaxed);
+    unsigned long long previousMax = s.maxNanoseconds.load(memory_order_relaxed);
+    while (nanoseconds > previousMax &&
+           !s.maxNanoseconds.compare_exchange_weak(previousMax, nanoseconds, memory_order_relaxed));
+}
+
+/**
+ * Clears every measurement
+ */
+void Instrumentation::reset() {
+    for (OperationStats &s: stats) {
+        s.calls = 0;
+        s.totalNanoseconds = 0;
+        s.maxNanoseconds = 0;
+        s.nodesExpanded = 0;
+        s.edgesScanned = 0;
+        s.airlineIntersections = 0;
+        for (auto &bucket: s.buckets) bucket = 0;
+    }
+}
+
+/**
+ * Builds a human readable table with the measurements of every operation that was executed at least once
+ * @return The table, or a note saying instrumentation is disabled in this build
+ */
+string Instrumentation::dumpText() {
+    if (!enabled()) return "Instrumentation is disabled in this build (configure with -DAIRTRANSPORT_INSTRUMENTATION=ON).\n";
+    ostringstream out;
+    out << "operation            calls    total_ms     mean_us      p50_us      p99_us      max_us"
+           "      nodes      edges  intersections\n";
+    for (int i = 0; i < (int) Operation::NUM_OPERATIONS; i++) {
+        const OperationStats &s = stats[i];
+        unsigned long long calls = s.calls.load(memory_order_relaxed);
+        if (calls == 0) continue;
+        out.width(18);
+        out << left << operationName((Operation) i) << right;
+        out.width(8);
+        out << calls;
+        out.precision(3);
+        out << fixed;
+        out.width(12);
+        out << s.totalNanoseconds / 1e6;
+        out.width(12);
+        out << s.totalNanoseconds / 1e3 / calls;
+        out.width(12);
+        out << percentile(s, 0.5) / 1e3;
+        out.width(12);
+        out << percentile(s, 0.99) / 1e3;
+        out.width(12);
+        out << s.maxNanoseconds / 1e3;
+        out.width(11);
+        out << s.nodesExpanded;
+        out.width(11);
+        out << s.edgesScanned;
+        out.width(15);
+        out << s.airlineIntersections << '\n';
+    }
+    return out.str();
+}
+
+/**
+ * Builds a single line JSON object with the measurements and latency histogram of every operation that was executed at least once
+ * @return The JSON object, with "enabled": false if instrumentation is disabled in this build
+ */
+string Instrumentation::dumpJson() {
+    ostringstream out;
+    out << "{\"enabled\":" << (enabled() ? "true" : "false") << ",\"operations\":{";
+    bool first = true;
+    for (int i = 0; enabled() && i < (int) Operation::NUM_OPERATIONS; i++) {
+        const OperationStats &s = stats[i];
+        if (s.calls == 0) continue;
+        if (!first) out << ',';
+        first = false;
+        out << '"' << operationName((Operation) i) << "\":{\"calls\":" << s.calls
+            << ",\"total_ns\":" << s.totalNanoseconds << ",\"max_ns\":" << s.maxNanoseconds
+            << ",\"p50_ns\":" << percentile(s, 0.5) << ",\"p99_ns\":" << percentile(s, 0.99)
+            << ",\"nodes_expanded\":" << s.nodesExpanded << ",\"edges_scanned\":" << s.edgesScanned
+            << ",\"airline_intersections\":" << s.airlineIntersections << ",\"histogram_ns\":{";
+        bool firstBucket = true;
+        for (unsigned b = 0; b < NUM_BUCKETS; b++) {
+            unsigned long long count = s.buckets[b].load(memory_order_relaxed);
+            if (count == 0) continue;
+            if (!firstBucket) out << ',';
+            firstBucket = false;
+            out << '"' << (b == 0 ? 0 : 1ULL << b) << "\":" << count;
+        }
+        out << "}}";
+    }
+    out << "}}";
+    return out.str();
+}
@@ -0,0 +1,93 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <chrono>
+#include <string>
+
+// Operations measured by the instrumentation. Built with AIRTRANSPORT_INSTRUMENTATION undefined, measurements compile to nothing
+enum class Operation {
+    LOAD_AIRLINES,
+    LOAD_AIRPORTS,
+    LOAD_FLIGHTS,
+    SHORTEST_PATH_BFS,
+    BFS_DISTANCE,
+    DFS_SCC,
+    GEO_LOOKUP,
+    AIRPORT_SEARCH,
+    QUERY_PARSE,
+    QUERY_EXECUTE,
+    QUERY_FORMAT,
+    NUM_OPERATIONS
+};
+
+class Instrumentation {
+public:
+    unsigned static const NUM_BUCKETS = 48; // Latency histogram buckets: bucket i holds durations in [2^(i-1), 2^i) ns
+
+    static constexpr bool enabled() {
+#ifdef AIRTRANSPORT_INSTRUMENTATION
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static void record(Operation operation, unsigned long long nanoseconds, unsigned long long nodesExpanded,
+                       unsigned long long edgesScanned, unsigned long long airlineIntersections);
+
+    static void reset();
+
+    static std::string dumpText();
+
+    static std::string dumpJson();
+
+    static const char *operationName(Operation operation);
+};
+
+#ifdef AIRTRANSPORT_INSTRUMENTATION
+
+/**
+ * Times its scope and counts the traversal work done in it, adding both to the totals of an operation when destroyed
+ */
+class ScopedMeasurement {
+private:
+    Operation operation;
+    std::chrono::steady_clock::time_point start;
+    unsigned long long nodes = 0;
+    unsigned long long edges = 0;
+    unsigned long long intersections = 0;
+public:
+    explicit ScopedMeasurement(Operation operation) : operation(operation), start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedMeasurement() {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        Instrumentation::record(operation, elapsed.count(), nodes, edges, intersections);
+    }
+
+    ScopedMeasurement(const ScopedMeasurement &) = delete;
+
+    ScopedMeasurement &operator=(const ScopedMeasurement &) = delete;
+
+    void nodeExpanded() { nodes++; }
+
+    void edgeScanned() { edges++; }
+
+    void airlineIntersection() { intersections++; }
+};
+
+#else
+
+class ScopedMeasurement {
+public:
+    explicit ScopedMeasurement(Operation) {}
+
+    void nodeExpanded() {}
+
+    void edgeScanned() {}
+
+    void airlineIntersection() {}
+};
+
+#endif
+
+#endif
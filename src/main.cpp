@@ -1,7 +1,240 @@
+#include <chrono>
+#include <csignal>
+#include <cstring>
 #include "menu.h"
+#include "batchProcessor.h"
+#include "queryServer.h"
+#include "instrumentation.h"
+#include "memoryReport.h"
+#include "airlineAnalytics.h"
+#include "resilienceAnalysis.h"
+#include "centralityAnalysis.h"
+#include "neighbourhoodFunction.h"
+#include "eccentricityCache.h"
 
-int main() {
-    Menu menu;
-    menu.initializeMenu();
+static QueryServer *runningServer = nullptr;
+
+/**
+ * Stops the running server on SIGINT or SIGTERM
+ */
+extern "C" void handleStopSignal(int) {
+    if (runningServer != nullptr) runningServer->stop();
+}
+
+/**
+ * Loads the dataset, listens on the given address and serves queries until interrupted
+ * @param address - unix:PATH or tcp:PORT (TCP servers only listen on localhost)
+ * @param engine - Engine executing the queries
+ * @param numWorkers - Number of worker threads, or 0 for one per hardware thread
+ * @return Exit code of the program
+ */
+int serve(const string &address, const QueryEngine &engine, unsigned numWorkers) {
+    QueryServer server(engine, numWorkers);
+    string error;
+    bool listening;
+    if (address.rfind("unix:", 0) == 0) listening = server.listenUnix(address.substr(5), error);
+    else if (address.rfind("tcp:", 0) == 0 && address.size() > 4 && address.size() <= 9 &&
+             address.find_first_not_of("0123456789", 4) == string::npos && stoul(address.substr(4)) <= 65535)
+        listening = server.listenTcp((unsigned short) stoul(address.substr(4)), error);
+    else {
+        error = "expected unix:PATH or tcp:PORT";
+        listening = false;
+    }
+    if (!listening) {
+        cerr << "Couldn't listen on " << address << ": " << error << endl;
+        return 1;
+    }
+
+    runningServer = &server;
+    signal(SIGINT, handleStopSignal);
+    signal(SIGTERM, handleStopSignal);
+    cerr << "Serving queries on " << address << endl;
+    server.run();
+    runningServer = nullptr;
+    return 0;
+}
+
+/**
+ * Outputs the instrumentation measurements to stderr
+ * @param format - "text", "json", or empty to output nothing
+ */
+void printMetrics(const string &format) {
+    if (format == "text") cerr << Instrumentation::dumpText();
+    else if (format == "json") cerr << Instrumentation::dumpJson() << endl;
+}
+
+/**
+ * Outputs the accepted command line options
+ */
+void printUsage(const char *program) {
+    cerr << "Usage: " << program << " [--dataset DIR] [--batch FILE|- [--format csv|jsonl] [--output FILE] [--workers N]]"
+         << endl
+         << "       " << program << " [--dataset DIR] --serve unix:PATH|tcp:PORT [--workers N]" << endl
+         << "       " << program << " [--dataset DIR] --report REPORT [--workers N] [--top N] [--pivots N] [--tolerance X]"
+         << " [--output FILE]" << endl
+         << "--workers N sets the number of threads executing queries or computing reports (default: one per" << endl
+         << "  hardware thread); batch results are still written in the order of the queries." << endl
+         << "--cache-size N sets how many route results are cached in batch and server modes (0 disables it)." << endl
+         << "--metrics text|json prints the instrumentation measurements to stderr when batch or server mode ends." << endl
+         << "--node-order load|degree|rcm renumbers the airports after loading (hubs first, or breadth-first) so" << endl
+         << "  whole-network searches touch memory more locally; results don't depend on it except for ties." << endl
+         << "--memory-report prints the memory used by each data structure to stderr after loading and at the end." << endl
+         << "--report airlines writes the airports, SCCs, largest SCC and diameter of each airline's network as CSV." << endl
+         << "--report resilience writes the airports and routes whose loss would disconnect the network as CSV." << endl
+         << "--report betweenness writes the --top N (default 20, 0 for all) airports with the highest betweenness;" << endl
+         << "  --pivots N estimates it from N sampled source airports instead of all of them." << endl
+         << "--report pagerank writes the --top N airports by PageRank, weighting flights by their number of airlines;" << endl
+         << "  it iterates until the scores change less than --tolerance X (default 1e-9)." << endl
+         << "--report neighbourhood estimates how many pairs of airports are connected within each number of flights," << endl
+         << "  and prints the effective diameter and average path length to stderr." << endl
+         << "--report eccentricity writes the eccentricity of every airport, marking the centre and the periphery," << endl
+         << "  and prints the radius and diameter to stderr." << endl
+         << "Without --batch, --serve or --report, the interactive menu is started." << endl;
+}
+
+int main(int argc, char *argv[]) {
+    string datasetDir = DataLoader::DEFAULT_DATASET_DIR, batchInput, outputPath, serveAddress, report;
+    OutputFormat format = OutputFormat::CSV;
+    unsigned numWorkers = 0, topN = 20, numPivots = 0;
+    double tolerance = 1e-9;
+    size_t cacheCapacity = QueryEngine::DEFAULT_CACHE_CAPACITY;
+    string metricsFormat;
+    bool memoryReport = false;
+    NodeOrder nodeOrder = NodeOrder::LOAD;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--dataset") && hasValue) datasetDir = argv[++i];
+        else if (!strcmp(argv[i], "--batch") && hasValue) batchInput = argv[++i];
+        else if (!strcmp(argv[i], "--output") && hasValue) outputPath = argv[++i];
+        else if (!strcmp(argv[i], "--serve") && hasValue) serveAddress = argv[++i];
+        else if (!strcmp(argv[i], "--report") && hasValue) {
+            report = argv[++i];
+            if (report != "airlines" && report != "resilience" && report != "betweenness" &&
+                report != "pagerank" && report != "neighbourhood" &&
+                report != "eccentricity") {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        else if (!strcmp(argv[i], "--workers") && hasValue) numWorkers = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--top") && hasValue) topN = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--pivots") && hasValue) numPivots = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--tolerance") && hasValue) tolerance = strtod(argv[++i], nullptr);
+        else if (!strcmp(argv[i], "--cache-size") && hasValue) cacheCapacity = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--memory-report")) memoryReport = true;
+        else if (!strcmp(argv[i], "--node-order") && hasValue) {
+            string order = argv[++i];
+            if (order == "degree") nodeOrder = NodeOrder::DEGREE;
+            else if (order == "rcm") nodeOrder = NodeOrder::RCM;
+            else if (order != "load") {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        else if (!strcmp(argv[i], "--metrics") && hasValue) {
+            metricsFormat = argv[++i];
+            if (metricsFormat != "text" && metricsFormat != "json") {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        else if (!strcmp(argv[i], "--format") && hasValue) {
+            if (!ResultFormatter::parseFormat(argv[++i], format)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (batchInput.empty() && serveAddress.empty() && report.empty()) {
+        Menu menu;
+        if (!menu.initializeMenu(datasetDir)) {
+            cerr << "Couldn't read the dataset in " << datasetDir << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    ios::sync_with_stdio(false);
+    Graph graph(0);
+    DataRepository dataRepository;
+    if (!DataLoader(dataRepository, graph).extractFileInfo(datasetDir)) {
+        cerr << "Couldn't read the dataset in " << datasetDir << endl;
+        return 1;
+    }
+    graph.reorderNodes(nodeOrder);
+    if (memoryReport) cerr << "After loading:" << endl << MemoryReport::toText(dataRepository, graph);
+    if (!report.empty()) {
+        ofstream outputFile;
+        if (!outputPath.empty()) {
+            outputFile.open(outputPath);
+            if (!outputFile.is_open()) {
+                cerr << "Couldn't open " << outputPath << endl;
+                return 1;
+            }
+        }
+        ostream &out = outputPath.empty() ? cout : outputFile;
+        if (report == "airlines") AirlineAnalytics::writeCsv(out, AirlineAnalytics::compute(graph, numWorkers));
+        else if (report == "resilience") ResilienceAnalysis::writeCsv(out, graph, ResilienceAnalysis::compute(graph));
+        else if (report == "betweenness")
+            CentralityAnalysis::writeTopCsv(out, graph, CentralityAnalysis::betweenness(graph, numPivots, numWorkers),
+                                            "betweenness", topN);
+        else if (report == "pagerank")
+            CentralityAnalysis::writeTopCsv(out, graph, CentralityAnalysis::pageRank(graph, 0.85, tolerance, 100,
+                                                                                     numWorkers), "pagerank", topN);
+        else if (report == "eccentricity") {
+            Eccentricities eccentricities = Eccentricities::compute(graph, numWorkers);
+            eccentricities.writeCsv(out, graph);
+            cerr << "Radius: " << eccentricities.radius << " flights (" << eccentricities.centre.size()
+                 << " central airports), diameter: " << eccentricities.diameter << " flights ("
+                 << eccentricities.periphery.size() << " peripheral airports)" << endl;
+        } else {
+            NeighbourhoodFunction neighbourhood = NeighbourhoodFunction::compute(graph, 7, numWorkers);
+            neighbourhood.writeCsv(out);
+            cerr << "Effective diameter: " << neighbourhood.effectiveDiameter() << " flights, average path length: "
+                 << neighbourhood.averagePathLength() << " flights (each airport's count has a relative standard "
+                 << "error of " << neighbourhood.relativeStandardError() * 100 << "%)" << endl;
+        }
+        return 0;
+    }
+    QueryEngine engine(graph, dataRepository, cacheCapacity);
+    if (!serveAddress.empty()) {
+        int exitCode = serve(serveAddress, engine, numWorkers);
+        printMetrics(metricsFormat);
+        if (memoryReport) cerr << "After serving:" << endl << MemoryReport::toText(dataRepository, graph);
+        return exitCode;
+    }
+
+    ifstream inputFile;
+    if (batchInput != "-") {
+        inputFile.open(batchInput);
+        if (!inputFile.is_open()) {
+            cerr << "Couldn't open " << batchInput << endl;
+            return 1;
+        }
+    }
+    ofstream outputFile;
+    if (!outputPath.empty()) {
+        outputFile.open(outputPath);
+        if (!outputFile.is_open()) {
+            cerr << "Couldn't open " << outputPath << endl;
+            return 1;
+        }
+    }
+
+    BatchProcessor processor(engine, format, numWorkers);
+    auto start = chrono::steady_clock::now();
+    unsigned processed = processor.run(batchInput == "-" ? cin : inputFile,
+                                       outputPath.empty() ? cout : outputFile);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cerr << "Processed " << processed << " queries in " << seconds * 1000 << " ms ("
+         << (seconds > 0 ? processed / seconds : 0) << " queries/s, " << engine.getRouteCache().getHits()
+         << " route cache hits, " << engine.getRouteCache().getMisses() << " misses)" << endl;
+    printMetrics(metricsFormat);
+    if (memoryReport) cerr << "After the queries:" << endl << MemoryReport::toText(dataRepository, graph);
     return 0;
-}
\ No newline at end of file
+}
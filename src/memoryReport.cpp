@@ -0,0 +1,164 @@
+#include "memoryReport.h"
+#include <sstream>
+#include "memoryTracker.h"
+
+using namespace std;
+
+namespace {
+    // Sizes below follow libstdc++'s layouts: hash table nodes hold a next pointer, the value and (for these hashers)
+    // the cached hash code, list nodes hold two pointers and the value, and strings keep up to 15 chars inline
+    size_t const POINTER = sizeof(void *);
+
+    size_t roundUp(size_t bytes) {
+        return (bytes + POINTER - 1) / POINTER * POINTER;
+    }
+
+    void addString(StructureMemory &usage, const string &text) {
+        if (text.capacity() > 15) {
+            usage.bytes += text.capacity() + 1;
+            usage.allocations++;
+        }
+    }
+
+    void addAirport(StructureMemory &usage, const Airport &airport) {
+        for (const string *text: {&airport.getCode(), &airport.getName(), &airport.getCity(), &airport.getCountry()})
+            addString(usage, *text);
+    }
+
+    void addAirline(StructureMemory &usage, const Airline &airline) {
+        for (const string *text: {&airline.getCode(), &airline.getName(), &airline.getCallsign(),
+                                  &airline.getCountry()})
+            addString(usage, *text);
+    }
+
+    // Containers allocating from an Arena take their bytes from its blocks, which are counted separately
+    template<typename HashTable>
+    void addHashTable(StructureMemory &usage, const HashTable &table, bool inArena = false) {
+        usage.bytes += table.size() * roundUp(POINTER + sizeof(typename HashTable::value_type) + sizeof(size_t));
+        if (!inArena) usage.allocations += table.size();
+        if (table.bucket_count() > 1) { // A single bucket is stored inside the table itself
+            usage.bytes += table.bucket_count() * POINTER;
+            if (!inArena) usage.allocations++;
+        }
+    }
+
+    template<typename List>
+    void addList(StructureMemory &usage, const List &list, bool inArena = false) {
+        usage.bytes += list.size() * roundUp(2 * POINTER + sizeof(typename List::value_type));
+        if (!inArena) usage.allocations += list.size();
+    }
+
+    template<typename T>
+    void addCodeMap(StructureMemory &usage, const CodeMap<T> &map) {
+        if (map.slotBytes() > 0) {
+            usage.bytes += map.slotBytes();
+            usage.allocations++;
+        }
+        addHashTable(usage, map.getUnpacked());
+        for (const auto &entry: map.getUnpacked()) addString(usage, entry.first);
+    }
+
+    template<typename Vector>
+    void addVector(StructureMemory &usage, const Vector &vector) {
+        if (vector.capacity() == 0) return;
+        usage.bytes += vector.capacity() * sizeof(typename Vector::value_type);
+        usage.allocations++;
+    }
+}
+
+/**
+ * Estimates the heap memory used by each data structure by walking it, using the container layouts of libstdc++
+ * Time Complexity: O(|V| + |E| * m + c), where m is the largest number of airlines on an Edge and c the number of cities
+ * @param dataRepository - Repository to measure
+ * @param graph - Graph to measure
+ * @return vector with the usage of each structure
+ */
+vector<StructureMemory> MemoryReport::estimate(const DataRepository &dataRepository, const Graph &graph) {
+    StructureMemory airlines{"DataRepository::airlines"}, airports{"DataRepository::airports"},
+            cities{"DataRepository::cityIndex"}, nodes{"Graph::nodes"}, edges{"Graph edge lists"},
+            edgeAirlines{"Graph edge airlineTables"}, codeToNode{"Graph::codeToNode"},
+            searchIndex{"DataRepository::searchIndex"};
+
+    addHashTable(airlines, dataRepository.getAirlines());
+    for (const Airline &airline: dataRepository.getAirlines()) addAirline(airlines, airline);
+    addCodeMap(airlines, dataRepository.getAirlinesByCode());
+
+    addHashTable(airports, dataRepository.getAirports());
+    for (const Airport &airport: dataRepository.getAirports()) addAirport(airports, airport);
+    addCodeMap(airports, dataRepository.getAirportsByCode());
+    addVector(airports, dataRepository.getAirportsById());
+
+    addHashTable(cities, dataRepository.getCityIds());
+    for (const auto &entry: dataRepository.getCityIds()) {
+        addString(cities, entry.first.first);
+        addString(cities, entry.first.second);
+    }
+    addVector(cities, dataRepository.getCityOffsets());
+    addVector(cities, dataRepository.getCityAirports());
+
+    const pmr::memory_resource *edgeArena = &graph.getEdgeArena();
+    edges.allocations += graph.getEdgeArena().numBlocks();
+    addVector(nodes, graph.getNodes());
+    for (const auto &node: graph.getNodes()) {
+        addAirport(nodes, node.airport);
+        addList(edges, node.adj, node.adj.get_allocator().resource() == edgeArena);
+        for (const auto &edge: node.adj) {
+            addHashTable(edgeAirlines, edge.airlines, edge.airlines.get_allocator().resource() == edgeArena);
+            for (const Airline &airline: edge.airlines) addAirline(edgeAirlines, airline);
+        }
+    }
+
+    addCodeMap(codeToNode, graph.getCodeToNode());
+
+    searchIndex.bytes = dataRepository.getSearchIndex().memoryUsage();
+    searchIndex.allocations = dataRepository.getSearchIndex().empty() ? 0 : 4; // Its airports, weights, text and keys
+
+    return {airlines, airports, cities, nodes, edges, edgeAirlines, codeToNode, searchIndex};
+}
+
+/**
+ * Builds a table with the estimated usage of each data structure and, if the tracking allocator is enabled, the
+ * bytes and allocations it attributed to each category
+ * @param dataRepository - Repository to measure
+ * @param graph - Graph to measure
+ * @return The table
+ */
+string MemoryReport::toText(const DataRepository &dataRepository, const Graph &graph) {
+    ostringstream out;
+    size_t totalBytes = 0, totalAllocations = 0;
+    out << "Estimated heap usage:\n";
+    for (const StructureMemory &usage: estimate(dataRepository, graph)) {
+        out.width(34);
+        out << left << usage.structure << right;
+        out.width(14);
+        out << usage.bytes << " bytes";
+        out.width(11);
+        out << usage.allocations << " allocations\n";
+        totalBytes += usage.bytes;
+        totalAllocations += usage.allocations;
+    }
+    out.width(34);
+    out << left << "total" << right;
+    out.width(14);
+    out << totalBytes << " bytes";
+    out.width(11);
+    out << totalAllocations << " allocations\n";
+
+    if (!MemoryTracker::enabled()) {
+        out << "Allocation tracking is disabled in this build (configure with -DAIRTRANSPORT_TRACK_ALLOCATIONS=ON).\n";
+        return out.str();
+    }
+    out << "Tracked allocations:\n";
+    for (int i = 0; i < (int) MemoryCategory::NUM_CATEGORIES; i++) {
+        MemoryStats stats = MemoryTracker::stats((MemoryCategory) i);
+        out.width(34);
+        out << left << MemoryTracker::categoryName((MemoryCategory) i) << right;
+        out.width(14);
+        out << stats.liveBytes << " bytes";
+        out.width(11);
+        out << stats.liveAllocations << " live";
+        out.width(12);
+        out << stats.totalAllocations << " total allocations\n";
+    }
+    return out.str();
+}
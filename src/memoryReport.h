@@ -0,0 +1,22 @@
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <string>
+#include <vector>
+#include "graph.h"
+#include "dataRepository.h"
+
+struct StructureMemory {
+    std::string structure; // Name of the data structure
+    size_t bytes = 0; // Heap bytes requested by the structure (excluding the allocator's own overhead)
+    size_t allocations = 0; // Number of heap blocks the structure is made of
+};
+
+class MemoryReport {
+public:
+    static std::vector<StructureMemory> estimate(const DataRepository &dataRepository, const Graph &graph);
+
+    static std::string toText(const DataRepository &dataRepository, const Graph &graph);
+};
+
+#endif
@@ -0,0 +1,134 @@
+#include "memoryTracker.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+namespace {
+    struct CategoryCounters {
+        atomic<long long> liveBytes{0};
+        atomic<long long> liveAllocations{0};
+        atomic<unsigned long long> totalAllocations{0};
+    };
+
+    CategoryCounters counters[(int) MemoryCategory::NUM_CATEGORIES];
+    thread_local MemoryCategory currentCategory = MemoryCategory::UNTRACKED;
+}
+
+const char *MemoryTracker::categoryName(MemoryCategory category) {
+    static const char *names[] = {"untracked", "DataRepository::airlines", "DataRepository::airports",
+                                  "DataRepository::cityIndex", "Graph::nodes", "Graph edges",
+                                  "Graph::codeToNode", "DataRepository::searchIndex", "queries"};
+    return names[(int) category];
+}
+
+/**
+ * Returns the allocation counters of a category, all zero if tracking is disabled
+ */
+MemoryStats MemoryTracker::stats(MemoryCategory category) {
+    const CategoryCounters &c = counters[(int) category];
+    return {c.liveBytes.load(memory_order_relaxed), c.liveAllocations.load(memory_order_relaxed),
+            c.totalAllocations.load(memory_order_relaxed)};
+}
+
+/**
+ * Sets the category the current thread's allocations are attributed to
+ * @return The previous category
+ */
+MemoryCategory MemoryTracker::setCurrentCategory(MemoryCategory category) {
+    MemoryCategory previous = currentCategory;
+    currentCategory = category;
+    return previous;
+}
+
+#ifdef AIRTRANSPORT_TRACK_ALLOCATIONS
+
+namespace {
+    // Every tracked block is preceded by a header holding its size, category and the address malloc returned; its
+    // 16 byte alignment keeps malloc's
+    struct alignas(16) BlockHeader {
+        size_t size;
+        MemoryCategory category;
+        void *base;
+    };
+
+    void *trackedAllocate(size_t size, size_t alignment = alignof(BlockHeader)) noexcept {
+        if (alignment < alignof(BlockHeader)) alignment = alignof(BlockHeader);
+        void *base = malloc(sizeof(BlockHeader) + size + alignment - alignof(BlockHeader));
+        if (base == nullptr) return nullptr;
+        uintptr_t first = (uintptr_t) base + sizeof(BlockHeader);
+        auto *header = (BlockHeader *) ((first + alignment - 1) / alignment * alignment) - 1;
+        header->base = base;
+        header->size = size;
+        header->category = currentCategory;
+        CategoryCounters &c = counters[(int) currentCategory];
+        c.liveBytes.fetch_add((long long) size, memory_order_relaxed);
+        c.liveAllocations.fetch_add(1, memory_order_relaxed);
+        c.totalAllocations.fetch_add(1, memory_order_relaxed);
+        return header + 1;
+    }
+
+    void trackedFree(void *pointer) noexcept {
+        if (pointer == nullptr) return;
+        BlockHeader *header = (BlockHeader *) pointer - 1;
+        CategoryCounters &c = counters[(int) header->category];
+        c.liveBytes.fetch_sub((long long) header->size, memory_order_relaxed);
+        c.liveAllocations.fetch_sub(1, memory_order_relaxed);
+        free(header->base);
+    }
+
+    void *allocateOrThrow(size_t size, size_t alignment = alignof(BlockHeader)) {
+        void *pointer = trackedAllocate(size == 0 ? 1 : size, alignment);
+        if (pointer == nullptr) throw bad_alloc();
+        return pointer;
+    }
+}
+
+void *operator new(size_t size) { return allocateOrThrow(size); }
+
+void *operator new[](size_t size) { return allocateOrThrow(size); }
+
+void *operator new(size_t size, const nothrow_t &) noexcept { return trackedAllocate(size == 0 ? 1 : size); }
+
+void *operator new[](size_t size, const nothrow_t &) noexcept { return trackedAllocate(size == 0 ? 1 : size); }
+
+void operator delete(void *pointer) noexcept { trackedFree(pointer); }
+
+void operator delete[](void *pointer) noexcept { trackedFree(pointer); }
+
+void operator delete(void *pointer, size_t) noexcept { trackedFree(pointer); }
+
+void operator delete[](void *pointer, size_t) noexcept { trackedFree(pointer); }
+
+void operator delete(void *pointer, const nothrow_t &) noexcept { trackedFree(pointer); }
+
+void operator delete[](void *pointer, const nothrow_t &) noexcept { trackedFree(pointer); }
+
+// Over-aligned allocations, made for instance by std::pmr::new_delete_resource
+void *operator new(size_t size, align_val_t alignment) { return allocateOrThrow(size, (size_t) alignment); }
+
+void *operator new[](size_t size, align_val_t alignment) { return allocateOrThrow(size, (size_t) alignment); }
+
+void *operator new(size_t size, align_val_t alignment, const nothrow_t &) noexcept {
+    return trackedAllocate(size == 0 ? 1 : size, (size_t) alignment);
+}
+
+void *operator new[](size_t size, align_val_t alignment, const nothrow_t &) noexcept {
+    return trackedAllocate(size == 0 ? 1 : size, (size_t) alignment);
+}
+
+void operator delete(void *pointer, align_val_t) noexcept { trackedFree(pointer); }
+
+void operator delete[](void *pointer, align_val_t) noexcept { trackedFree(pointer); }
+
+void operator delete(void *pointer, size_t, align_val_t) noexcept { trackedFree(pointer); }
+
+void operator delete[](void *pointer, size_t, align_val_t) noexcept { trackedFree(pointer); }
+
+void operator delete(void *pointer, align_val_t, const nothrow_t &) noexcept { trackedFree(pointer); }
+
+void operator delete[](void *pointer, align_val_t, const nothrow_t &) noexcept { trackedFree(pointer); }
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef MEMORYTRACKER_H
+#define MEMORYTRACKER_H
+
+#include <cstddef>
+
+// Data structures heap allocations are attributed to. Allocations made outside a MemoryScope are UNTRACKED
+enum class MemoryCategory {
+    UNTRACKED,
+    AIRLINES,
+    AIRPORTS,
+    CITY_INDEX,
+    GRAPH_NODES,
+    GRAPH_EDGES,
+    CODE_TO_NODE,
+    SEARCH_INDEX,
+    QUERIES,
+    NUM_CATEGORIES
+};
+
+struct MemoryStats {
+    long long liveBytes = 0; // Bytes allocated and not yet freed
+    long long liveAllocations = 0; // Allocations not yet freed
+    unsigned long long totalAllocations = 0; // Allocations ever made
+};
+
+/**
+ * Tracking allocator: with AIRTRANSPORT_TRACK_ALLOCATIONS defined, the global operator new and delete are replaced by
+ * versions that count bytes and allocations per MemoryCategory. Otherwise every function is a no-op
+ */
+class MemoryTracker {
+public:
+    static constexpr bool enabled() {
+#ifdef AIRTRANSPORT_TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static MemoryStats stats(MemoryCategory category);
+
+    static const char *categoryName(MemoryCategory category);
+
+    static MemoryCategory setCurrentCategory(MemoryCategory category);
+};
+
+/**
+ * Attributes the allocations made by the current thread during its lifetime to a category
+ */
+class MemoryScope {
+#ifdef AIRTRANSPORT_TRACK_ALLOCATIONS
+private:
+    MemoryCategory previous;
+public:
+    explicit MemoryScope(MemoryCategory category) : previous(MemoryTracker::setCurrentCategory(category)) {}
+
+    ~MemoryScope() { MemoryTracker::setCurrentCategory(previous); }
+
+    MemoryScope(const MemoryScope &) = delete;
+
+    MemoryScope &operator=(const MemoryScope &) = delete;
+#else
+public:
+    explicit MemoryScope(MemoryCategory) {}
+#endif
+};
+
+#endif
@@ -4,170 +4,46 @@ using namespace std;
 
 unsigned const Menu::COLUMN_WIDTH = 45;
 unsigned const Menu::COLUMNS_PER_LINE = 3;
-string const Menu::airlinesFilePath = "../dataset/airlines.csv";
-string const Menu::airportsFilePath = "../dataset/airports.csv";
-string const Menu::flightsFilePath = "../dataset/flights.csv";
+unsigned const Menu::NUM_SUGGESTIONS = 5;
 
 Menu::Menu() = default;
 
 /**
- * Delegates extracting file info, calling the appropriate functions for each file
+ * Outputs to the screen a message indicating that the given Airport doesn't exist, followed by the airports whose code,
+ * name or city are closest to the code that was entered
+ * @param code - Code that was entered
  */
-void
-Menu::extractFileInfo() {
-    extractAirlinesFile();
-    extractAirportsFile();
-    extractFlightsFile();
-}
-
-/**
- * Extracts and stores the information of airlines.csv
- * Time Complexity: O(n²) (worst case) | 0(n) (average case), where n is the number of lines of airlines.csv
- */
-void Menu::extractAirlinesFile() {
-
-    ifstream airlines(airlinesFilePath);
-
-    string currentParam, currentLine;
-    string code, name, callsign, country;
-
-    int counter = 0;
-
-    getline(airlines, currentParam); //Ignore first line with just descriptors
-
-    while (getline(airlines, currentLine)) {
-        istringstream iss(currentLine);
-        while (getline(iss, currentParam, ',')) {
-            switch (counter++) {
-                case 0: {
-                    code = currentParam;
-                    break;
-                }
-                case 1: {
-                    name = currentParam;
-                    break;
-                }
-                case 2: {
-                    callsign = currentParam;
-                    break;
-                }
-                case 3: {
-                    country = currentParam;
-                    counter = 0;
-                    break;
-                }
-            }
-            if (counter == 0) {
-                dataRepository.addAirlineEntry(code, name, callsign, country);
-            }
-        }
-    }
-}
-
-/**
- * Extracts and stores the information of airports.csv
- * Time Complexity: O(n²) (worst case) | 0(n) (average case), where n is the number of lines of airports.csv
- */
-void Menu::extractAirportsFile() {
-    {
-        ifstream airports(airportsFilePath);
-
-        string currentParam, currentLine;
-        string code, name, city, country;
-        float latitude, longitude;
-
-        int counter = 0;
-
-        getline(airports, currentParam); //Ignore first line with just descriptors
-
-        while (getline(airports, currentLine)) {
-            istringstream iss(currentLine);
-            while (getline(iss, currentParam, ',')) {
-                switch (counter++) {
-                    case 0: {
-                        code = currentParam;
-                        break;
-                    }
-                    case 1: {
-                        name = currentParam;
-                        break;
-                    }
-                    case 2: {
-                        city = currentParam;
-                        break;
-                    }
-                    case 3: {
-                        country = currentParam;
-                        break;
-                    }
-                    case 4: {
-                        latitude = stof(currentParam);
-                        break;
-                    }
-                    case 5: {
-                        longitude = stof(currentParam);
-                        counter = 0;
-                        break;
-                    }
-                }
-                if (counter == 0) {
-                    Airport newAirport = dataRepository.addAirportEntry(code, name, city, country, latitude, longitude);
-                    graph.addNode(newAirport);
-                    dataRepository.addAirportToCityEntry(city, country, newAirport);
-                }
-            }
-        }
+void Menu::airportDoesntExist(const string &code) const {
+    cout << "An airport with this code doesn't exist!" << endl;
+    vector<AirportMatch> matches = dataRepository.searchAirports(code, NUM_SUGGESTIONS, 1);
+    if (matches.empty()) return;
+    cout << "Did you mean:" << endl;
+    for (const AirportMatch &match: matches) {
+        const Airport &airport = *match.airport;
+        cout << "  " << airport.getCode() << " - " << airport.getName() << " (" << airport.getCity() << ", "
+             << airport.getCountry() << ")" << endl;
     }
 }
 
 /**
- * Extracts and stores the information of flights.csv
- * Time Complexity: O(n), where n is the number of lines of flights.csv
+ * Outputs to the screen a message indicating that the given city and country combination is not valid, followed by
+ * the cities whose names are closest to the city that was entered
+ * @param city - City that was entered
  */
-void Menu::extractFlightsFile() {
-
-    ifstream flights(flightsFilePath);
-
-    string currentParam, currentLine;
-    string sourceCode, targetCode, airlineCode;
-
-    int counter = 0;
-
-    getline(flights, currentParam); //Ignore first line with just descriptors
-
-    while (getline(flights, currentLine)) {
-        istringstream iss(currentLine);
-        while (getline(iss, currentParam, ',')) {
-            switch (counter++) {
-                case 0: {
-                    sourceCode = currentParam;
-                    break;
-                }
-                case 1: {
-                    targetCode = currentParam;
-                    break;
-                }
-                case 2: {
-                    airlineCode = currentParam;
-                    counter = 0;
-                    break;
-                }
-            }
-            if (counter == 0) {
-                int sourceNode = graph.findAirportNode(sourceCode);
-                int targetNode = graph.findAirportNode(targetCode);
-                optional<Airline> airline = dataRepository.findAirline(airlineCode);
-                graph.addEdge(sourceNode, targetNode, airline.value());
-            }
+void Menu::cityDoesntExist(const string &city) const {
+    cout << "This city and country combination is not valid!" << endl;
+    vector<pair<string, string>> cities;
+    for (const AirportMatch &match: dataRepository.searchAirports(city, 10 * NUM_SUGGESTIONS)) {
+        pair<string, string> cityCountry = {match.airport->getCity(), match.airport->getCountry()};
+        if (match.field != SearchField::CITY || find(cities.begin(), cities.end(), cityCountry) != cities.end()) {
+            continue;
         }
+        cities.push_back(cityCountry);
+        if (cities.size() == NUM_SUGGESTIONS) break;
     }
-}
-
-/**
- * Outputs to the screen a message indicating that the given Airport doesn't exist
- */
-void Menu::airportDoesntExist() {
-    cout << "An airport with this code doesn't exist!" << endl;
+    if (cities.empty()) return;
+    cout << "Did you mean:" << endl;
+    for (const auto &[suggestedCity, country]: cities) cout << "  " << suggestedCity << ", " << country << endl;
 }
 
 /**
@@ -251,12 +127,12 @@ airlineTable Menu::airlineRestrictionsMenu() {
                 cout << "Please enter the code of your preferred airline: ";
                 cin >> code;
                 if (!checkInput(3)) break;
-                optional<Airline> airline = dataRepository.findAirline(code);
-                if (!airline.has_value()) {
+                const Airline *airline = dataRepository.findAirline(code);
+                if (airline == nullptr) {
                     airlineDoesntExist();
                     break;
                 }
-                validAirlines.insert(airline.value());
+                validAirlines.insert(*airline);
                 return validAirlines;
             }
             case '3': {
@@ -267,12 +143,12 @@ airlineTable Menu::airlineRestrictionsMenu() {
 
                 while (code != "q") {
                     if (!checkInput(3)) break;
-                    optional<Airline> airline = dataRepository.findAirline(code);
-                    if (!airline.has_value()) {
+                    const Airline *airline = dataRepository.findAirline(code);
+                    if (airline == nullptr) {
                         airlineDoesntExist();
                         break;
                     }
-                    validAirlines.insert(airline.value());
+                    validAirlines.insert(*airline);
                     cout << "Please enter the code of your preferred airline, or q to finish: ";
                     cin >> code;
                 }
@@ -285,13 +161,64 @@ airlineTable Menu::airlineRestrictionsMenu() {
     }
 }
 
+/**
+ * Asks the user what the suggested routes should minimise
+ * @return - The chosen RouteCriterion
+ */
+RouteCriterion Menu::routeCriterionMenu() {
+    unsigned char commandIn;
+
+    cout << setw(COLUMN_WIDTH) << setfill(' ') << "Fewest flights: [1]" << setw(COLUMN_WIDTH)
+         << "Fewest airline changes: [2]" << setw(COLUMN_WIDTH) << "Flights/distance/changes trade-offs: [3]" << endl;
+
+    while (true) {
+        cout << "Please select what your route should minimise: ";
+        cin >> commandIn;
+
+        if (!checkInput(1)) {
+            continue;
+        }
+        switch (commandIn) {
+            case '1':
+                return RouteCriterion::FLIGHTS;
+            case '2':
+                return RouteCriterion::AIRLINE_CHANGES;
+            case '3':
+                return RouteCriterion::PARETO;
+            default:
+                cout << "Please press one of listed keys." << endl;
+                break;
+        }
+    }
+}
+
+/**
+ * Outputs the suggested paths, each airport followed by the airlines whose flights reach it
+ * @param paths - Paths to output, in the format of Graph::getShortestPath
+ */
+void Menu::printPaths(const list<list<pair<airlineTable, string>>> &paths) {
+    cout << endl << "We suggest you take one of the following paths: " << endl;
+    for (const auto &path: paths) {
+        for (const pair<airlineTable, string> &flights: path) {
+            cout << flights.second;
+            if (!flights.first.empty()) cout << " (flights by:";
+            for (const Airline &airline: flights.first) {
+                cout << " " << airline.getCode();
+            }
+            if (!flights.first.empty()) cout << ")";
+            if (flights.second != path.back().second) cout << " -> ";
+        }
+        cout << endl;
+    }
+}
+
 /**
  * Outputs flights menu screen and decides graph function calls according to user input
  * @return - Last inputted command, or '\0' for previous menu command
  */
 unsigned Menu::flightsMenu() {
     unsigned char commandIn = '\0';
-    list<Airport> departure, arrival;
+    list<int> departure, arrival; // Indexes of the graph nodes of the chosen airports
 
     while (commandIn != 'q') {
 
@@ -323,16 +250,16 @@ unsigned Menu::flightsMenu() {
                         cin >> airportCode;
                         if (!checkInput(3)) break;
 
-                        optional<Airport> airport = dataRepository.findAirport(airportCode);
-                        if (!airport.has_value()) {
-                            airportDoesntExist();
+                        const Airport *airport = dataRepository.findAirport(airportCode);
+                        if (airport == nullptr) {
+                            airportDoesntExist(airportCode);
                             break;
                         }
                         if (currentSelection == "departure") {
-                            departure = {airport.value()};
+                            departure = {graph.findAirportNode(airport->getCode())};
                             validFirstInput = true;
                         } else {
-                            arrival = {airport.value()};
+                            arrival = {graph.findAirportNode(airport->getCode())};
                             validFullInput = true;
                         }
 
@@ -349,15 +276,18 @@ unsigned Menu::flightsMenu() {
                         getline(cin, country);
                         if (!checkInput()) break;
                         if (!dataRepository.checkValidCityCountry(city, country)) {
-                            cout << "This city and country combination is not valid!" << endl;
+                            cityDoesntExist(city);
                             break;
                         }
 
+                        list<int> cityNodes;
+                        for (uint32_t id: dataRepository.findAirportsInCity(city, country))
+                            cityNodes.push_back(graph.findAirportNode(dataRepository.getAirport(id).getCode()));
                         if (currentSelection == "departure") {
-                            departure = dataRepository.findAirportsInCity(city, country);
+                            departure = std::move(cityNodes);
                             validFirstInput = true;
                         } else {
-                            arrival = dataRepository.findAirportsInCity(city, country);
+                            arrival = std::move(cityNodes);
                             validFullInput = true;
                         }
 
@@ -388,11 +318,15 @@ unsigned Menu::flightsMenu() {
                         cin >> maxDistance;
                         if (!checkInput()) break;
 
+                        list<int> locationNodes;
+                        for (const Airport &airport: dataRepository.findAirportsInLocation(latitude, longitude,
+                                                                                            maxDistance))
+                            locationNodes.push_back(graph.findAirportNode(airport.getCode()));
                         if (currentSelection == "departure") {
-                            departure = dataRepository.findAirportsInLocation(latitude, longitude, maxDistance);
+                            departure = std::move(locationNodes);
                             validFirstInput = true;
                         } else {
-                            arrival = dataRepository.findAirportsInLocation(latitude, longitude, maxDistance);
+                            arrival = std::move(locationNodes);
                             validFullInput = true;
                         }
                         break;
@@ -414,24 +348,18 @@ unsigned Menu::flightsMenu() {
 
         if (validFullInput) {
             airlineTable validAirlines = airlineRestrictionsMenu();
-            auto result = graph.getShortestPath(departure, arrival, validAirlines);
+            RouteCriterion criterion = routeCriterionMenu();
+            list<list<pair<airlineTable, string>>> result;
+            if (criterion == RouteCriterion::AIRLINE_CHANGES)
+                result = graph.getFewestChangesPath(departure, arrival, validAirlines);
+            else if (criterion == RouteCriterion::PARETO)
+                result = graph.getParetoPaths(departure, arrival, validAirlines);
+            else result = graph.getShortestPath(departure, arrival, validAirlines);
             if (result.size() == 0 || result.front().size() == 0) {
                 cout << endl << "We couldn't find any valid flights for your preferences." << endl;
                 continue;
             }
-            cout << endl << "We suggest you take one of the following paths: " << endl;
-            for (auto path: result) {
-                for (const pair<airlineTable, string> &flights: path) {
-                    cout << flights.second;
-                    if (!flights.first.empty()) cout << " (flights by:";
-                    for (const Airline &airline: flights.first) {
-                        cout << " " << airline.getCode();
-                    }
-                    if (!flights.first.empty()) cout << ")";
-                    if (flights.second != path.back().second) cout << " -> ";
-                }
-                cout << endl;
-            }
+            printPaths(result);
         }
     }
     return commandIn;
@@ -476,12 +404,12 @@ unsigned Menu::airportInfoMenu() {
                     cout << "Please enter the code of the airport you'd like to obtain information about: ";
                     cin >> airportCode;
                     if (!checkInput(3)) break;
-                    optional<Airport> airport = dataRepository.findAirport(airportCode);
-                    if (!airport.has_value()) {
-                        airportDoesntExist();
+                    const Airport *airport = dataRepository.findAirport(airportCode);
+                    if (airport == nullptr) {
+                        airportDoesntExist(airportCode);
                         break;
                     }
-                    cout << graph.numFlights(airport.value()) << " flights leave from " << airport->getName()
+                    cout << graph.numFlights(*airport) << " flights leave from " << airport->getName()
                          << " airport." << endl;
                     break;
                 }
@@ -490,12 +418,12 @@ unsigned Menu::airportInfoMenu() {
                     cout << "Please enter the code of the airport you'd like to obtain information about: ";
                     cin >> airportCode;
                     if (!checkInput(3)) break;
-                    optional<Airport> airport = dataRepository.findAirport(airportCode);
-                    if (!airport.has_value()) {
-                        airportDoesntExist();
+                    const Airport *airport = dataRepository.findAirport(airportCode);
+                    if (airport == nullptr) {
+                        airportDoesntExist(airportCode);
                         break;
                     }
-                    cout << graph.numAirlines(airport.value()) << " airlines carry flights that leave from "
+                    cout << graph.numAirlines(*airport) << " airlines carry flights that leave from "
                          << airport->getName() << " airport." << endl;
                     break;
                 }
@@ -504,12 +432,12 @@ unsigned Menu::airportInfoMenu() {
                     cout << "Please enter the code of the airport you'd like to obtain information about: ";
                     cin >> airportCode;
                     if (!checkInput(3)) break;
-                    optional<Airport> airport = dataRepository.findAirport(airportCode);
-                    if (!airport.has_value()) {
-                        airportDoesntExist();
+                    const Airport *airport = dataRepository.findAirport(airportCode);
+                    if (airport == nullptr) {
+                        airportDoesntExist(airportCode);
                         break;
                     }
-                    cout << graph.numDestinations(airport.value()) << " cities are directly reachable from "
+                    cout << graph.numDestinations(*airport) << " cities are directly reachable from "
                          << airport->getName() << " airport." << endl;
                     break;
                 }
@@ -518,12 +446,12 @@ unsigned Menu::airportInfoMenu() {
                     cout << "Please enter the code of the airport you'd like to obtain information about: ";
                     cin >> airportCode;
                     if (!checkInput(3)) break;
-                    optional<Airport> airport = dataRepository.findAirport(airportCode);
-                    if (!airport.has_value()) {
-                        airportDoesntExist();
+                    const Airport *airport = dataRepository.findAirport(airportCode);
+                    if (airport == nullptr) {
+                        airportDoesntExist(airportCode);
                         break;
                     }
-                    cout << graph.numCountries(airport.value()) << " countries are directly reachable from "
+                    cout << graph.numCountries(*airport) << " countries are directly reachable from "
                          << airport->getName() << " airport." << endl;
                     break;
                 }
@@ -532,9 +460,9 @@ unsigned Menu::airportInfoMenu() {
                     cout << "Please enter the code of the airport you'd like to obtain information about: ";
                     cin >> airportCode;
                     if (!checkInput(3)) break;
-                    optional<Airport> airport = dataRepository.findAirport(airportCode);
-                    if (!airport.has_value()) {
-                        airportDoesntExist();
+                    const Airport *airport = dataRepository.findAirport(airportCode);
+                    if (airport == nullptr) {
+                        airportDoesntExist(airportCode);
                         break;
                     }
 
@@ -543,7 +471,7 @@ unsigned Menu::airportInfoMenu() {
                     cin >> numFlights;
                     if (!checkInput(5)) break;
 
-                    cout << graph.numAirportsInXFlights(airport.value(), numFlights)
+                    cout << graph.numAirportsInXFlights(*airport, numFlights)
                          << " other airports are reachable in "
                          << numFlights << " or less flights from "
                          << airport->getName() << " airport." << endl;
@@ -554,9 +482,9 @@ unsigned Menu::airportInfoMenu() {
                     cout << "Please enter the code of the airport you'd like to obtain information about: ";
                     cin >> airportCode;
                     if (!checkInput(3)) break;
-                    optional<Airport> airport = dataRepository.findAirport(airportCode);
-                    if (!airport.has_value()) {
-                        airportDoesntExist();
+                    const Airport *airport = dataRepository.findAirport(airportCode);
+                    if (airport == nullptr) {
+                        airportDoesntExist(airportCode);
                         break;
                     }
 
@@ -565,7 +493,7 @@ unsigned Menu::airportInfoMenu() {
                     cin >> numFlights;
                     if (!checkInput(5)) break;
 
-                    cout << graph.numCitiesInXFlights(airport.value(), numFlights) << " other cities are reachable in "
+                    cout << graph.numCitiesInXFlights(*airport, numFlights) << " other cities are reachable in "
                          << numFlights << " or less flights from "
                          << airport->getName() << " airport." << endl;
                     break;
@@ -575,9 +503,9 @@ unsigned Menu::airportInfoMenu() {
                     cout << "Please enter the code of the airport you'd like to obtain information about: ";
                     cin >> airportCode;
                     if (!checkInput(3)) break;
-                    optional<Airport> airport = dataRepository.findAirport(airportCode);
-                    if (!airport.has_value()) {
-                        airportDoesntExist();
+                    const Airport *airport = dataRepository.findAirport(airportCode);
+                    if (airport == nullptr) {
+                        airportDoesntExist(airportCode);
                         break;
                     }
 
@@ -586,7 +514,7 @@ unsigned Menu::airportInfoMenu() {
                     cin >> numFlights;
                     if (!checkInput(5)) break;
 
-                    cout << graph.numCountriesInXFlights(airport.value(), numFlights)
+                    cout << graph.numCountriesInXFlights(*airport, numFlights)
                          << " other countries are reachable in "
                          << numFlights << " or less flights from "
                          << airport->getName() << " airport." << endl;
@@ -629,7 +557,8 @@ unsigned Menu::generalInfoMenu() {
                  << "Number of countries: [5]" << setw(COLUMN_WIDTH)
                  << "Number of strongly connected components: [6]" << endl;
             cout << setw(COLUMN_WIDTH) << "Diameter: [7]" << setw(COLUMN_WIDTH)
-                 << "Back: [b]" << setw(COLUMN_WIDTH) << "Quit: [q]" << endl;
+                 << "Instrumentation report: [8]" << setw(COLUMN_WIDTH) << "Memory usage: [9]" << endl;
+            cout << setw(COLUMN_WIDTH) << "Back: [b]" << setw(COLUMN_WIDTH) << "Quit: [q]" << endl;
         }
 
         while (commandIn != 'q') {
@@ -657,7 +586,7 @@ unsigned Menu::generalInfoMenu() {
                     break;
                 }
                 case '4': {
-                    cout << "Our system includes " << dataRepository.getCityToAirports().size() << " different cities!"
+                    cout << "Our system includes " << dataRepository.getNumCities() << " different cities!"
                          << endl;
                     break;
                 }
@@ -675,6 +604,14 @@ unsigned Menu::generalInfoMenu() {
                     cout << "Our flights graph has a diameter of " << graph.getDiameter() << "!" << endl;
                     break;
                 }
+                case '8': {
+                    cout << Instrumentation::dumpText();
+                    break;
+                }
+                case '9': {
+                    cout << MemoryReport::toText(dataRepository, graph);
+                    break;
+                }
                 case 'b': {
                     return '\0';
                 }
@@ -776,9 +713,12 @@ bool Menu::checkInput(unsigned int checkLength) {
 
 /**
  * Delegates initialization of the menu, calling the appropriate functions for information extraction and output
+ * @param datasetDir - Directory containing airlines.csv, airports.csv and flights.csv
+ * @return true if the dataset could be read and the menu was shown, false otherwise
  */
-void Menu::initializeMenu() {
-    extractFileInfo();
+bool Menu::initializeMenu(const string &datasetDir) {
+    if (!DataLoader(dataRepository, graph).extractFileInfo(datasetDir)) return false;
     mainMenu();
+    return true;
 }
 
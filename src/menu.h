@@ -12,29 +12,23 @@
 #include <unordered_set>
 #include "graph.h"
 #include "dataRepository.h"
+#include "dataLoader.h"
+#include "instrumentation.h"
+#include "memoryReport.h"
+#include "query.h"
 
 class Menu {
 private:
     Graph graph = Graph(0);
     DataRepository dataRepository;
-    string static const airlinesFilePath;
-    string static const airportsFilePath;
-    string static const flightsFilePath;
     unsigned static const COLUMN_WIDTH;
     unsigned static const COLUMNS_PER_LINE;
+    unsigned static const NUM_SUGGESTIONS;
 
 public:
     Menu();
 
-    void extractAirlinesFile();
-
-    void extractAirportsFile();
-
-    void extractFlightsFile();
-
-    void extractFileInfo();
-
-    void initializeMenu();
+    bool initializeMenu(const string &datasetDir = DataLoader::DEFAULT_DATASET_DIR);
 
     unsigned int flightsMenu();
 
@@ -46,9 +40,15 @@ public:
 
     airlineTable airlineRestrictionsMenu();
 
+    static RouteCriterion routeCriterionMenu();
+
+    static void printPaths(const list<list<pair<airlineTable, string>>> &paths);
+
     unsigned int airportInfoMenu();
 
-    static void airportDoesntExist();
+    void airportDoesntExist(const string &code) const;
+
+    void cityDoesntExist(const string &city) const;
 
     static void airlineDoesntExist();
 
@@ -0,0 +1,186 @@
+#include "neighbourhoodFunction.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include "csrGraph.h"
+#include "threadPool.h"
+
+using namespace std;
+
+namespace {
+    uint64_t splitmix64(uint64_t x) {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+}
+
+/**
+ * Computes the HyperLogLog estimate of the number of elements added to a counter
+ * Time Complexity: O(m), where m is the number of registers
+ * @param registers - Registers of the counter
+ * @return Estimated number of distinct elements
+ */
+double NeighbourhoodFunction::estimate(const uint8_t *registers) const {
+    double sum = 0;
+    unsigned zeros = 0;
+    for (unsigned j = 0; j < numRegisters; j++) {
+        sum += ldexp(1.0, -registers[j]);
+        zeros += registers[j] == 0;
+    }
+    double m = numRegisters;
+    double alpha = m == 16 ? 0.673 : m == 32 ? 0.697 : m == 64 ? 0.709 : 0.7213 / (1 + 1.079 / m);
+    double raw = alpha * m * m / sum;
+    if (raw <= 2.5 * m && zeros != 0) return m * log(m / zeros); // Linear counting is more accurate for small sets
+    return raw;
+}
+
+/**
+ * Runs HyperANF on the graph: starting from counters holding only their own airport, each pass sets the counter of
+ * every airport to the union (register-wise maximum) of its own and its destinations' counters, until no counter
+ * changes. Passes are split into node blocks across worker threads.
+ * Time Complexity: O(d * (|V| + |E|) * m) split across the threads, where d is the diameter and m = 2^log2Registers
+ * @param graph - Graph to analyse
+ * @param log2Registers - Base 2 logarithm of the registers per counter (4 to 16); more registers lower the error
+ * @param numThreads - Number of worker threads, or 0 for one per hardware thread
+ * @param maxFlights - Largest number of flights to compute the neighbourhood function for
+ * @param seed - Seed of the hash function
+ * @return The neighbourhood function
+ */
+NeighbourhoodFunction NeighbourhoodFunction::compute(const Graph &graph, unsigned log2Registers, unsigned numThreads,
+                                                     unsigned maxFlights, uint64_t seed) {
+    NeighbourhoodFunction result;
+    log2Registers = max(4u, min(16u, log2Registers));
+    int n = result.n = graph.getN();
+    unsigned m = result.numRegisters = 1u << log2Registers;
+    CsrGraph csr = CsrGraph::fromGraph(graph);
+
+    vector<uint8_t> current((size_t) (n + 1) * m, 0), next;
+    for (int v = 1; v <= n; v++) {
+        uint64_t hash = splitmix64(seed ^ (uint64_t) v);
+        uint64_t rest = hash << log2Registers;
+        uint8_t rank = rest == 0 ? 64 - log2Registers + 1 : __builtin_clzll(rest) + 1;
+        current[(size_t) v * m + (hash >> (64 - log2Registers))] = rank;
+    }
+    next = current;
+
+    ThreadPool pool(numThreads);
+    const int blockSize = 256;
+    unsigned numBlocks = (n + blockSize - 1) / blockSize;
+    auto estimateAll = [&](const vector<uint8_t> &counters) {
+        vector<float> estimates(n + 1, 0);
+        pool.parallelFor(numBlocks, [&](unsigned block, unsigned) {
+            int first = 1 + (int) block * blockSize, last = min(n, first + blockSize - 1);
+            for (int v = first; v <= last; v++) estimates[v] = (float) result.estimate(&counters[(size_t) v * m]);
+        });
+        return estimates;
+    };
+    result.reachable.push_back(estimateAll(current));
+
+    for (unsigned flights = 1; flights <= maxFlights; flights++) {
+        atomic<bool> changed{false};
+        pool.parallelFor(numBlocks, [&](unsigned block, unsigned) {
+            int first = 1 + (int) block * blockSize, last = min(n, first + blockSize - 1);
+            bool blockChanged = false;
+            for (int v = first; v <= last; v++) {
+                uint8_t *target = &next[(size_t) v * m];
+                const uint8_t *own = &current[(size_t) v * m];
+                copy(own, own + m, target);
+                for (int i = csr.offsets[v]; i < csr.offsets[v + 1]; i++) {
+                    const uint8_t *other = &current[(size_t) csr.targets[i] * m];
+                    for (unsigned j = 0; j < m; j++) target[j] = max(target[j], other[j]);
+                }
+                blockChanged = blockChanged || !equal(own, own + m, target);
+            }
+            if (blockChanged) changed = true;
+        });
+        if (!changed) break;
+        current.swap(next);
+        result.reachable.push_back(estimateAll(current));
+    }
+    return result;
+}
+
+/**
+ * Returns the largest number of flights the neighbourhood function was computed for; every counter had stopped
+ * changing by then, unless maxFlights was reached
+ */
+int NeighbourhoodFunction::getMaxFlights() const {
+    return (int) reachable.size() - 1;
+}
+
+/**
+ * Estimates the number of airports reachable from an airport in the given number of flights or less
+ * Time Complexity: O(1)
+ * @param v - Index of the node of the airport
+ * @param numFlights - Max number of flights
+ * @return Estimated number of reachable airports, excluding the airport itself
+ */
+double NeighbourhoodFunction::reachableWithin(int v, unsigned numFlights) const {
+    if (reachable.empty() || v < 1 || v > n) return 0;
+    return max(0.0, (double) reachable[min(numFlights, (unsigned) getMaxFlights())][v] - 1);
+}
+
+/**
+ * Estimates the number of ordered pairs of different airports connected by the given number of flights or less
+ * Time Complexity: O(|V|)
+ * @param numFlights - Max number of flights
+ * @return Estimated number of pairs
+ */
+double NeighbourhoodFunction::pairsWithin(unsigned numFlights) const {
+    double total = 0;
+    for (int v = 1; v <= n; v++) total += reachableWithin(v, numFlights);
+    return total;
+}
+
+/**
+ * Estimates the effective diameter: the number of flights, interpolated linearly, within which the given fraction of
+ * the connected pairs of airports are connected
+ * Time Complexity: O(d * |V|), where d is the diameter
+ * @param fraction - Fraction of the connected pairs
+ * @return Estimated effective diameter
+ */
+double NeighbourhoodFunction::effectiveDiameter(double fraction) const {
+    double goal = fraction * pairsWithin(getMaxFlights()), previous = 0;
+    for (int flights = 1; flights <= getMaxFlights(); flights++) {
+        double pairs = pairsWithin(flights);
+        if (pairs >= goal) return flights - 1 + (pairs > previous ? (goal - previous) / (pairs - previous) : 1);
+        previous = pairs;
+    }
+    return getMaxFlights();
+}
+
+/**
+ * Estimates the average number of flights of the shortest route between two connected airports
+ * Time Complexity: O(d * |V|), where d is the diameter
+ * @return Estimated average path length
+ */
+double NeighbourhoodFunction::averagePathLength() const {
+    double weighted = 0, previous = 0;
+    for (int flights = 1; flights <= getMaxFlights(); flights++) {
+        double pairs = pairsWithin(flights);
+        weighted += flights * (pairs - previous);
+        previous = pairs;
+    }
+    return previous > 0 ? weighted / previous : 0;
+}
+
+/**
+ * Returns the relative standard error of each counter, 1.04 / sqrt(m)
+ */
+double NeighbourhoodFunction::relativeStandardError() const {
+    return numRegisters == 0 ? 0 : 1.04 / sqrt((double) numRegisters);
+}
+
+/**
+ * Writes the estimated number of connected pairs of airports for each number of flights as CSV, with a header line
+ * @param out - Stream to write to
+ */
+void NeighbourhoodFunction::writeCsv(ostream &out) const {
+    string text = "flights,pairs\n";
+    for (int flights = 0; flights <= getMaxFlights(); flights++) {
+        text += to_string(flights) + ',' + to_string((long long) llround(pairsWithin(flights))) + '\n';
+    }
+    out << text;
+}
@@ -0,0 +1,41 @@
+#ifndef NEIGHBOURHOODFUNCTION_H
+#define NEIGHBOURHOODFUNCTION_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "graph.h"
+
+/**
+ * Approximate neighbourhood function of a graph, computed with HyperANF: every airport keeps a HyperLogLog counter of
+ * the airports it reaches, and each pass over the edges merges the counters of its destinations into it, so after x
+ * passes it counts the airports reachable within x flights
+ */
+class NeighbourhoodFunction {
+private:
+    int n = 0;
+    unsigned numRegisters = 0;
+    std::vector<std::vector<float>> reachable; // reachable[x][v]: estimated airports reachable from v in x flights or less
+
+    double estimate(const uint8_t *registers) const;
+
+public:
+    static NeighbourhoodFunction compute(const Graph &graph, unsigned log2Registers = 7, unsigned numThreads = 0,
+                                         unsigned maxFlights = 1000, uint64_t seed = 1);
+
+    int getMaxFlights() const;
+
+    double reachableWithin(int v, unsigned numFlights) const;
+
+    double pairsWithin(unsigned numFlights) const;
+
+    double effectiveDiameter(double fraction = 0.9) const;
+
+    double averagePathLength() const;
+
+    double relativeStandardError() const;
+
+    void writeCsv(std::ostream &out) const;
+};
+
+#endif
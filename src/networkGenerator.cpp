@@ -0,0 +1,273 @@
+#include "networkGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <unordered_set>
+
+using namespace std;
+
+NetworkGenerator::NetworkGenerator(const GeneratorOptions &options) : options(options), state(options.seed) {
+    if (NetworkGenerator::options.numClusters == 0) NetworkGenerator::options.numClusters = 1;
+    if (NetworkGenerator::options.maxAirlinesPerRoute == 0) NetworkGenerator::options.maxAirlinesPerRoute = 1;
+}
+
+/**
+ * Returns the next value of the splitmix64 sequence
+ */
+unsigned long long NetworkGenerator::nextRandom() {
+    unsigned long long z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Returns a uniformly distributed value in [0, 1)
+ */
+double NetworkGenerator::nextUnit() {
+    return (double) (nextRandom() >> 11) * 0x1.0p-53;
+}
+
+/**
+ * Returns a normally distributed value with mean 0 and standard deviation 1 (Box-Muller transform)
+ */
+double NetworkGenerator::nextGaussian() {
+    double u1 = 1.0 - nextUnit(), u2 = nextUnit();
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/**
+ * Picks a position of a cumulative weight array with probability proportional to its weight
+ * Time Complexity: O(log n), where n is the size of cumulative
+ */
+unsigned NetworkGenerator::pickWeighted(const vector<double> &cumulative) {
+    double value = nextUnit() * cumulative.back();
+    auto it = upper_bound(cumulative.begin(), cumulative.end(), value);
+    return min((unsigned) (it - cumulative.begin()), (unsigned) cumulative.size() - 1);
+}
+
+/**
+ * Builds a unique uppercase code for an index: the first 26^minLength indexes get minLength letters, the following ones one more letter, and so on
+ * @param index - Index of the airport or airline
+ * @param minLength - Length of the shortest codes
+ */
+string NetworkGenerator::makeCode(unsigned index, unsigned minLength) {
+    unsigned long long capacity = 1;
+    for (unsigned i = 0; i < minLength; i++) capacity *= 26;
+    unsigned length = minLength;
+    unsigned long long rest = index;
+    while (rest >= capacity) {
+        rest -= capacity;
+        capacity *= 26;
+        length++;
+    }
+    string code(length, 'A');
+    for (unsigned i = length; i-- > 0; rest /= 26) code[i] = (char) ('A' + rest % 26);
+    return code;
+}
+
+/**
+ * Generates the airlines, each based in one of the clusters
+ * Time Complexity: O(n), where n is the number of airlines
+ * @return vector with the generated Airlines
+ */
+vector<Airline> NetworkGenerator::generateAirlines() {
+    vector<Airline> airlines;
+    airlines.reserve(options.numAirlines);
+    for (unsigned i = 0; i < options.numAirlines; i++) {
+        airlines.emplace_back(makeCode(i, 3), "Airline " + to_string(i), "AIRLINE" + to_string(i),
+                              "Country " + to_string(i % options.numClusters));
+    }
+    return airlines;
+}
+
+/**
+ * Generates the airports. Airport i belongs to cluster i % numClusters, so every cluster gets some of the largest hubs,
+ * and is placed around its cluster's centre. Every two airports of a cluster share a city, and every cluster is a country
+ * Time Complexity: O(n), where n is the number of airports
+ * @return vector with the generated Airports
+ */
+vector<Airport> NetworkGenerator::generateAirports() {
+    vector<pair<double, double>> centres;
+    for (unsigned c = 0; c < options.numClusters; c++) {
+        double latitude = asin(2 * nextUnit() - 1) * 180 / M_PI; // Uniform over the sphere's surface
+        centres.emplace_back(max(-60.0, min(70.0, latitude)), nextUnit() * 360 - 180);
+    }
+
+    vector<Airport> airports;
+    airports.reserve(options.numAirports);
+    for (unsigned i = 0; i < options.numAirports; i++) {
+        unsigned cluster = i % options.numClusters, rank = i / options.numClusters;
+        double latitude = centres[cluster].first + nextGaussian() * options.clusterSpread;
+        double longitude = centres[cluster].second + nextGaussian() * options.clusterSpread;
+        latitude = max(-90.0, min(90.0, latitude));
+        longitude = fmod(fmod(longitude + 180, 360) + 360, 360) - 180;
+        airports.emplace_back(makeCode(i, 3), "Airport " + to_string(i),
+                              "City " + to_string(cluster) + "-" + to_string(rank / 2),
+                              "Country " + to_string(cluster), (float) latitude, (float) longitude);
+    }
+    return airports;
+}
+
+/**
+ * Generates the flights. Airport i gets a Zipf weight 1/(i+1)^hubExponent, which sets both how many routes leave it and
+ * how likely it is to be picked as a destination. Destinations are picked in the source's cluster with probability
+ * localFraction, and every route is flown by 1 to maxAirlinesPerRoute airlines, preferring larger airlines based in the
+ * source's cluster
+ * Time Complexity: O(f log n), where f is the number of flights and n the number of airports
+ * @param emit - Function called with the source airport, target airport and airline indexes of every flight
+ * @return Number of flights generated
+ */
+unsigned long long NetworkGenerator::generateFlights(const function<void(unsigned, unsigned, unsigned)> &emit) {
+    unsigned n = options.numAirports, numClusters = options.numClusters;
+    if (n < 2 || options.numAirlines == 0) return 0;
+
+    vector<double> weight(n), globalCumulative(n);
+    vector<vector<unsigned>> clusterAirports(numClusters);
+    vector<vector<double>> clusterCumulative(numClusters);
+    double totalWeight = 0;
+    for (unsigned i = 0; i < n; i++) {
+        weight[i] = 1.0 / pow(i + 1, options.hubExponent);
+        totalWeight += weight[i];
+        globalCumulative[i] = totalWeight;
+        unsigned cluster = i % numClusters;
+        double previous = clusterCumulative[cluster].empty() ? 0 : clusterCumulative[cluster].back();
+        clusterAirports[cluster].push_back(i);
+        clusterCumulative[cluster].push_back(previous + weight[i]);
+    }
+
+    vector<double> airlineCumulative;
+    vector<vector<unsigned>> clusterAirlines(numClusters);
+    vector<vector<double>> clusterAirlineCumulative(numClusters);
+    for (unsigned a = 0; a < options.numAirlines; a++) {
+        double w = 1.0 / (a + 1);
+        airlineCumulative.push_back((airlineCumulative.empty() ? 0 : airlineCumulative.back()) + w);
+        unsigned cluster = a % numClusters;
+        double previous = clusterAirlineCumulative[cluster].empty() ? 0 : clusterAirlineCumulative[cluster].back();
+        clusterAirlines[cluster].push_back(a);
+        clusterAirlineCumulative[cluster].push_back(previous + w);
+    }
+
+    double meanWeight = totalWeight / n;
+    unsigned long long numFlights = 0;
+    unordered_set<unsigned> destinations, routeAirlines;
+    vector<unsigned> chosenAirlines;
+    for (unsigned src = 0; src < n; src++) {
+        unsigned cluster = src % numClusters;
+        double expected = options.routesPerAirport * weight[src] / meanWeight;
+        unsigned numRoutes = (unsigned) expected + (nextUnit() < expected - floor(expected) ? 1 : 0);
+        numRoutes = max(1u, min(numRoutes, n - 1));
+
+        destinations.clear();
+        for (unsigned attempts = 0; destinations.size() < numRoutes && attempts < numRoutes * 4; attempts++) {
+            bool local = nextUnit() < options.localFraction && clusterAirports[cluster].size() > 1;
+            unsigned dest = local ? clusterAirports[cluster][pickWeighted(clusterCumulative[cluster])]
+                                  : pickWeighted(globalCumulative);
+            if (dest != src) destinations.insert(dest);
+        }
+
+        for (unsigned dest: destinations) {
+            unsigned numAirlines = 1 + nextRandom() % min(options.maxAirlinesPerRoute, options.numAirlines);
+            routeAirlines.clear();
+            chosenAirlines.clear();
+            for (unsigned attempts = 0; routeAirlines.size() < numAirlines && attempts < numAirlines * 4; attempts++) {
+                bool home = nextUnit() < 0.5 && !clusterAirlines[cluster].empty();
+                unsigned airline = home ? clusterAirlines[cluster][pickWeighted(clusterAirlineCumulative[cluster])]
+                                        : pickWeighted(airlineCumulative);
+                if (routeAirlines.insert(airline).second) chosenAirlines.push_back(airline);
+            }
+            bool returnRoute = nextUnit() < options.returnProbability;
+            for (unsigned airline: chosenAirlines) {
+                emit(src, dest, airline);
+                numFlights++;
+                if (returnRoute) {
+                    emit(dest, src, airline);
+                    numFlights++;
+                }
+            }
+        }
+    }
+    return numFlights;
+}
+
+/**
+ * Writes the generated network as airlines.csv, airports.csv and flights.csv, in the format read by DataLoader
+ * @param directory - Existing directory to write the files to
+ * @param error - Reason the files couldn't be written, if they couldn't
+ * @return true if every file was written, false otherwise
+ */
+bool NetworkGenerator::writeDataset(const string &directory, string &error) {
+    ofstream airlinesFile(directory + "/airlines.csv"), airportsFile(directory + "/airports.csv"),
+            flightsFile(directory + "/flights.csv");
+    if (!airlinesFile || !airportsFile || !flightsFile) {
+        error = "couldn't create the files in " + directory;
+        return false;
+    }
+
+    vector<Airline> airlines = generateAirlines();
+    airlinesFile << "Code,Name,Callsign,Country\n";
+    for (const Airline &airline: airlines) {
+        airlinesFile << airline.getCode() << ',' << airline.getName() << ',' << airline.getCallsign() << ','
+                     << airline.getCountry() << '\n';
+    }
+
+    vector<Airport> airports = generateAirports();
+    airportsFile << "Code,Name,City,Country,Latitude,Longitude\n" << fixed;
+    airportsFile.precision(6);
+    for (const Airport &airport: airports) {
+        airportsFile << airport.getCode() << ',' << airport.getName() << ',' << airport.getCity() << ','
+                     << airport.getCountry() << ',' << airport.getLocation().getLatitude() << ','
+                     << airport.getLocation().getLongitude() << '\n';
+    }
+
+    string buffer = "Source,Target,Airline\n";
+    generateFlights([&](unsigned src, unsigned dest, unsigned airline) {
+        buffer += airports[src].getCode();
+        buffer += ',';
+        buffer += airports[dest].getCode();
+        buffer += ',';
+        buffer += airlines[airline].getCode();
+        buffer += '\n';
+        if (buffer.size() >= (1 << 20)) {
+            flightsFile.write(buffer.data(), (streamsize) buffer.size());
+            buffer.clear();
+        }
+    });
+    flightsFile.write(buffer.data(), (streamsize) buffer.size());
+
+    if (!airlinesFile || !airportsFile || !flightsFile) {
+        error = "couldn't write the files in " + directory;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Adds the generated network directly to a DataRepository and a Graph, as DataLoader would after reading it from files
+ * @param dataRepository - Repository to add the airlines, airports and cities to
+ * @param graph - Graph to add the airports and flights to
+ */
+void NetworkGenerator::buildInto(DataRepository &dataRepository, Graph &graph) {
+    vector<Airline> airlines = generateAirlines();
+    for (const Airline &airline: airlines) {
+        dataRepository.addAirlineEntry(airline.getCode(), airline.getName(), airline.getCallsign(),
+                                       airline.getCountry());
+    }
+
+    int firstNode = graph.getN() + 1;
+    for (const Airport &airport: generateAirports()) {
+        Airport newAirport = dataRepository.addAirportEntry(airport.getCode(), airport.getName(), airport.getCity(),
+                                                            airport.getCountry(),
+                                                            airport.getLocation().getLatitude(),
+                                                            airport.getLocation().getLongitude());
+        graph.addNode(newAirport);
+    }
+    dataRepository.buildCityIndex();
+    graph.setNodeCities(dataRepository);
+
+    generateFlights([&](unsigned src, unsigned dest, unsigned airline) {
+        graph.addEdge(firstNode + (int) src, firstNode + (int) dest, airlines[airline]);
+    });
+    graph.buildAirlineIndex();
+    dataRepository.buildSearchIndex([&graph](const Airport &airport) { return graph.numFlights(airport); });
+}
@@ -0,0 +1,54 @@
+#ifndef NETWORKGENERATOR_H
+#define NETWORKGENERATOR_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "airline.h"
+#include "airport.h"
+#include "graph.h"
+#include "dataRepository.h"
+
+struct GeneratorOptions {
+    unsigned numAirports = 3000;
+    unsigned numAirlines = 450;
+    unsigned numClusters = 50; // Geographic regions (one country each) the airports are grouped in
+    double routesPerAirport = 12; // Average number of destinations served from each airport
+    unsigned maxAirlinesPerRoute = 3; // Each route is flown by 1 to this many airlines
+    double hubExponent = 0.6; // Zipf exponent of the airport sizes: higher values concentrate routes on fewer hubs
+    double localFraction = 0.7; // Share of routes whose destination is in the same cluster as their source
+    double clusterSpread = 4.0; // Standard deviation, in degrees, of the airport positions around their cluster centre
+    double returnProbability = 0.95; // Probability of a route also being flown in the opposite direction
+    unsigned long long seed = 1;
+};
+
+class NetworkGenerator {
+private:
+    GeneratorOptions options;
+    unsigned long long state; // splitmix64 state, so the output doesn't depend on the standard library implementation
+
+    unsigned long long nextRandom();
+
+    double nextUnit();
+
+    double nextGaussian();
+
+    static std::string makeCode(unsigned index, unsigned minLength);
+
+    unsigned pickWeighted(const std::vector<double> &cumulative);
+
+public:
+    explicit NetworkGenerator(const GeneratorOptions &options);
+
+    std::vector<Airline> generateAirlines();
+
+    std::vector<Airport> generateAirports();
+
+    unsigned long long generateFlights(const std::function<void(unsigned, unsigned, unsigned)> &emit);
+
+    bool writeDataset(const std::string &directory, std::string &error);
+
+    void buildInto(DataRepository &dataRepository, Graph &graph);
+};
+
+#endif
@@ -0,0 +1,232 @@
+#include "query.h"
+#include <unordered_map>
+#include <sstream>
+
+using namespace std;
+
+/**
+ * Splits a query line into whitespace separated tokens, keeping text between double quotes as a single token
+ * Time Complexity: O(n), where n is the length of the line
+ * @param line - Line to split
+ * @return vector with the tokens of the line, in order
+ */
+vector<string> QueryParser::tokenize(const string &line) {
+    vector<string> tokens;
+    string current;
+    bool quoted = false, hasToken = false;
+    for (char c: line) {
+        if (c == '"') {
+            quoted = !quoted;
+            hasToken = true;
+        } else if (!quoted && isspace((unsigned char) c)) {
+            if (hasToken) tokens.push_back(current);
+            current.clear();
+            hasToken = false;
+        } else {
+            current += c;
+            hasToken = true;
+        }
+    }
+    if (hasToken) tokens.push_back(current);
+    return tokens;
+}
+
+/**
+ * Checks if a line holds no query, that is, if it is empty or a comment starting with #
+ * @param line - Line to check
+ * @return true if the line should be skipped, false otherwise
+ */
+bool QueryParser::isBlankOrComment(const string &line) {
+    size_t first = line.find_first_not_of(" \t\r");
+    return first == string::npos || line[first] == '#';
+}
+
+/**
+ * Parses a location starting at tokens[pos], advancing pos past it
+ * Accepted forms: airport CODE | city "CITY" "COUNTRY" | coords LATITUDE LONGITUDE MAX_DISTANCE
+ * @param tokens - Tokens of the query
+ * @param pos - Index of the first token of the location
+ * @param location - Location to fill in
+ * @param error - Reason the parsing failed, if it did
+ * @return true if a valid location was parsed, false otherwise
+ */
+bool QueryParser::parseLocation(const vector<string> &tokens, size_t &pos, Location &location, string &error) {
+    if (pos >= tokens.size()) {
+        error = "missing location";
+        return false;
+    }
+    const string &kind = tokens[pos++];
+    if (kind == "airport") {
+        if (pos >= tokens.size()) {
+            error = "missing airport code";
+            return false;
+        }
+        location.type = LocationType::AIRPORT;
+        location.code = tokens[pos++];
+        return true;
+    }
+    if (kind == "city") {
+        if (pos + 1 >= tokens.size()) {
+            error = "city locations need a city and a country";
+            return false;
+        }
+        location.type = LocationType::CITY;
+        location.city = tokens[pos++];
+        location.country = tokens[pos++];
+        return true;
+    }
+    if (kind == "coords") {
+        if (pos + 2 >= tokens.size()) {
+            error = "coordinate locations need a latitude, a longitude and a max distance";
+            return false;
+        }
+        location.type = LocationType::COORDINATES;
+        try {
+            location.latitude = stof(tokens[pos++]);
+            location.longitude = stof(tokens[pos++]);
+            location.maxDistance = stof(tokens[pos++]);
+        } catch (const exception &) {
+            error = "invalid coordinates";
+            return false;
+        }
+        if (location.latitude < -90 || location.latitude > 90 || location.longitude < -180 ||
+            location.longitude > 180 || location.maxDistance < 0) {
+            error = "coordinates out of range";
+            return false;
+        }
+        return true;
+    }
+    error = "unknown location type '" + kind + "'";
+    return false;
+}
+
+/**
+ * Parses a query line. Accepted queries:
+ *   route FROM TO [airlines CODE,CODE,...] [by flights|changes|pareto]   (FROM and TO being locations, see parseLocation)
+ *   airport flights|airlines|destinations|countries|eccentricity CODE
+ *   airport reachable-airports|reachable-cities|reachable-countries CODE X
+ *   global flights|connections|airports|airlines|cities|countries|scc|diameter|radius|cache-hits|cache-misses
+ *   search TEXT [edits K] [limit N]
+ * Time Complexity: O(n), where n is the length of the line
+ * @param line - Line to parse
+ * @param query - Query to fill in
+ * @param error - Reason the parsing failed, if it did
+ * @return true if the line holds a valid query, false otherwise
+ */
+bool QueryParser::parse(const string &line, Query &query, string &error) {
+    static const unordered_map<string, QueryType> airportStats = {
+            {"flights",             QueryType::AIRPORT_FLIGHTS},
+            {"airlines",            QueryType::AIRPORT_AIRLINES},
+            {"destinations",        QueryType::AIRPORT_DESTINATIONS},
+            {"countries",           QueryType::AIRPORT_COUNTRIES},
+            {"reachable-airports",  QueryType::AIRPORTS_IN_X_FLIGHTS},
+            {"reachable-cities",    QueryType::CITIES_IN_X_FLIGHTS},
+            {"reachable-countries", QueryType::COUNTRIES_IN_X_FLIGHTS},
+            {"eccentricity",        QueryType::AIRPORT_ECCENTRICITY}};
+    static const unordered_map<string, QueryType> globalStats = {
+            {"flights",     QueryType::GLOBAL_FLIGHTS},
+            {"connections", QueryType::GLOBAL_CONNECTIONS},
+            {"airports",    QueryType::GLOBAL_AIRPORTS},
+            {"airlines",    QueryType::GLOBAL_AIRLINES},
+            {"cities",      QueryType::GLOBAL_CITIES},
+            {"countries",   QueryType::GLOBAL_COUNTRIES},
+            {"scc",         QueryType::GLOBAL_SCCS},
+            {"diameter",    QueryType::GLOBAL_DIAMETER},
+            {"radius",      QueryType::GLOBAL_RADIUS},
+            {"cache-hits",  QueryType::GLOBAL_CACHE_HITS},
+            {"cache-misses", QueryType::GLOBAL_CACHE_MISSES}};
+
+    query = Query();
+    query.text = line;
+    vector<string> tokens = tokenize(line);
+    if (tokens.empty()) {
+        error = "empty query";
+        return false;
+    }
+
+    size_t pos = 1;
+    if (tokens[0] == "route") {
+        query.type = QueryType::ROUTE;
+        if (!parseLocation(tokens, pos, query.source, error)) return false;
+        if (!parseLocation(tokens, pos, query.target, error)) return false;
+        if (pos < tokens.size() && tokens[pos] == "airlines") {
+            if (pos + 1 >= tokens.size()) {
+                error = "expected 'airlines CODE,CODE,...'";
+                return false;
+            }
+            istringstream codes(tokens[pos + 1]);
+            string code;
+            while (getline(codes, code, ',')) {
+                if (!code.empty()) query.airlineCodes.push_back(code);
+            }
+            pos += 2;
+        }
+        if (pos < tokens.size()) {
+            if (tokens[pos] != "by" || pos + 1 >= tokens.size() ||
+                (tokens[pos + 1] != "flights" && tokens[pos + 1] != "changes" && tokens[pos + 1] != "pareto")) {
+                error = "expected 'airlines CODE,CODE,...' or 'by flights|changes|pareto'";
+                return false;
+            }
+            if (tokens[pos + 1] == "changes") query.criterion = RouteCriterion::AIRLINE_CHANGES;
+            else if (tokens[pos + 1] == "pareto") query.criterion = RouteCriterion::PARETO;
+            pos += 2;
+        }
+    } else if (tokens[0] == "airport") {
+        if (pos >= tokens.size() || airportStats.find(tokens[pos]) == airportStats.end()) {
+            error = "unknown airport statistic";
+            return false;
+        }
+        query.type = airportStats.at(tokens[pos++]);
+        if (pos >= tokens.size()) {
+            error = "missing airport code";
+            return false;
+        }
+        query.airportCode = tokens[pos++];
+        if (query.type == QueryType::AIRPORTS_IN_X_FLIGHTS || query.type == QueryType::CITIES_IN_X_FLIGHTS ||
+            query.type == QueryType::COUNTRIES_IN_X_FLIGHTS) {
+            if (pos >= tokens.size() || tokens[pos].empty() || tokens[pos].size() > 9 ||
+                tokens[pos].find_first_not_of("0123456789") != string::npos) {
+                error = "missing or invalid number of flights";
+                return false;
+            }
+            query.numFlights = stoul(tokens[pos++]);
+        }
+    } else if (tokens[0] == "global") {
+        if (pos >= tokens.size() || globalStats.find(tokens[pos]) == globalStats.end()) {
+            error = "unknown global statistic";
+            return false;
+        }
+        query.type = globalStats.at(tokens[pos++]);
+    } else if (tokens[0] == "search") {
+        query.type = QueryType::SEARCH;
+        if (pos >= tokens.size()) {
+            error = "missing text to search for";
+            return false;
+        }
+        query.searchText = tokens[pos++];
+        while (pos + 1 < tokens.size() && (tokens[pos] == "edits" || tokens[pos] == "limit")) {
+            const string &value = tokens[pos + 1];
+            if (value.empty() || value.size() > 4 || value.find_first_not_of("0123456789") != string::npos) {
+                error = "invalid number '" + value + "'";
+                return false;
+            }
+            if (tokens[pos] == "edits") {
+                query.maxEdits = (int) stoul(value);
+                if (query.maxEdits > (int) AirportSearchIndex::MAX_EDITS) {
+                    error = "at most " + to_string(AirportSearchIndex::MAX_EDITS) + " edits are allowed";
+                    return false;
+                }
+            } else query.limit = stoul(value);
+            pos += 2;
+        }
+    } else {
+        error = "unknown query '" + tokens[0] + "'";
+        return false;
+    }
+
+    if (pos != tokens.size()) {
+        error = "unexpected '" + tokens[pos] + "'";
+        return false;
+    }
+    return true;
+}
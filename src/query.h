@@ -0,0 +1,93 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include "airline.h"
+#include "airportSearchIndex.h"
+
+enum class LocationType {
+    AIRPORT,
+    CITY,
+    COORDINATES
+};
+
+struct Location {
+    LocationType type = LocationType::AIRPORT;
+    std::string code; // Airport code (AIRPORT)
+    std::string city; // City name (CITY)
+    std::string country; // Country the city belongs to (CITY)
+    float latitude = 0; // (COORDINATES)
+    float longitude = 0; // (COORDINATES)
+    float maxDistance = 0; // Max distance, in km, of the airports to the coordinates (COORDINATES)
+};
+
+enum class RouteCriterion {
+    FLIGHTS, // Fewest flights
+    AIRLINE_CHANGES, // Fewest airline changes, then fewest flights
+    PARETO // Every trade-off between flights, distance and airline changes
+};
+
+enum class QueryType {
+    ROUTE,
+    AIRPORT_FLIGHTS,
+    AIRPORT_AIRLINES,
+    AIRPORT_DESTINATIONS,
+    AIRPORT_COUNTRIES,
+    AIRPORTS_IN_X_FLIGHTS,
+    CITIES_IN_X_FLIGHTS,
+    COUNTRIES_IN_X_FLIGHTS,
+    AIRPORT_ECCENTRICITY,
+    GLOBAL_FLIGHTS,
+    GLOBAL_CONNECTIONS,
+    GLOBAL_AIRPORTS,
+    GLOBAL_AIRLINES,
+    GLOBAL_CITIES,
+    GLOBAL_COUNTRIES,
+    GLOBAL_SCCS,
+    GLOBAL_DIAMETER,
+    GLOBAL_RADIUS,
+    GLOBAL_CACHE_HITS,
+    GLOBAL_CACHE_MISSES,
+    SEARCH
+};
+
+struct Query {
+    QueryType type = QueryType::ROUTE;
+    std::string text; // The line the query was parsed from
+    Location source; // (ROUTE)
+    Location target; // (ROUTE)
+    std::vector<std::string> airlineCodes; // Airlines allowed on the route, empty meaning any airline (ROUTE)
+    RouteCriterion criterion = RouteCriterion::FLIGHTS; // What the route minimises (ROUTE)
+    std::string airportCode; // (AIRPORT_*, *_IN_X_FLIGHTS)
+    unsigned numFlights = 0; // (*_IN_X_FLIGHTS)
+    std::string searchText; // Start of an airport code, name or city (SEARCH)
+    int maxEdits = -1; // Max edits to the text, -1 choosing them by its length (SEARCH)
+    unsigned limit = AirportSearchIndex::DEFAULT_LIMIT; // Max number of airports returned (SEARCH)
+};
+
+struct QueryResult {
+    bool ok = true;
+    bool isRoute = false; // Whether the result holds paths rather than a value
+    bool isSearch = false; // Whether the result holds matches rather than a value
+    std::string error; // Reason the query failed, if !ok
+    long long value = 0; // Result of every query other than ROUTE
+    std::list<std::list<std::pair<airlineTable, std::string>>> paths; // Result of ROUTE queries
+    std::vector<AirportMatch> matches; // Result of SEARCH queries, best first
+};
+
+class QueryParser {
+public:
+    static std::vector<std::string> tokenize(const std::string &line);
+
+    static bool parse(const std::string &line, Query &query, std::string &error);
+
+    static bool isBlankOrComment(const std::string &line);
+
+private:
+    static bool parseLocation(const std::vector<std::string> &tokens, size_t &pos, Location &location,
+                              std::string &error);
+};
+
+#endif
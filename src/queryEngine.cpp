@@ -0,0 +1,197 @@
+#include "queryEngine.h"
+#include "memoryTracker.h"
+
+using namespace std;
+
+size_t const QueryEngine::DEFAULT_CACHE_CAPACITY = 4096;
+
+/**
+ * @param graph - Graph the queries are executed on
+ * @param dataRepository - Repository used to resolve codes, cities and coordinates
+ * @param cacheCapacity - Max number of route results kept in the cache, 0 disabling it
+ */
+QueryEngine::QueryEngine(const Graph &graph, const DataRepository &dataRepository, size_t cacheCapacity)
+        : graph(graph), dataRepository(dataRepository), routeCache(cacheCapacity) {}
+
+const Graph &QueryEngine::getGraph() const {
+    return graph;
+}
+
+const DataRepository &QueryEngine::getDataRepository() const {
+    return dataRepository;
+}
+
+const RouteCache &QueryEngine::getRouteCache() const {
+    return routeCache;
+}
+
+/**
+ * Finds the nodes of the Airports a query location refers to. Cities are read from the city index of the repository,
+ * without copying their Airports
+ * @param location - Location to resolve
+ * @param nodes - List to fill with the indexes of the graph nodes of the Airports of the location
+ * @param error - Reason the location is invalid, if it is
+ * @return true if the location refers to at least one Airport, false otherwise
+ */
+bool QueryEngine::resolveLocation(const Location &location, list<int> &nodes, string &error) const {
+    switch (location.type) {
+        case LocationType::AIRPORT: {
+            if (dataRepository.findAirport(location.code) == nullptr) {
+                error = "unknown airport " + location.code;
+                return false;
+            }
+            nodes = {graph.findAirportNode(location.code)};
+            break;
+        }
+        case LocationType::CITY: {
+            Span<uint32_t> cityAirports = dataRepository.findAirportsInCity(location.city, location.country);
+            if (cityAirports.empty()) {
+                error = "unknown city " + location.city + ", " + location.country;
+                return false;
+            }
+            for (uint32_t id: cityAirports) {
+                nodes.push_back(graph.findAirportNode(dataRepository.getAirport(id).getCode()));
+            }
+            break;
+        }
+        case LocationType::COORDINATES: {
+            for (const Airport &airport: dataRepository.findAirportsInLocation(location.latitude, location.longitude,
+                                                                                location.maxDistance)) {
+                nodes.push_back(graph.findAirportNode(airport.getCode()));
+            }
+            if (nodes.empty()) {
+                error = "no airports near the given coordinates";
+                return false;
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+/**
+ * Executes a parsed query against the graph and the data repository
+ * Time Complexity: that of the Graph or DataRepository function answering the query
+ * @param query - Query to execute
+ * @return Result of the query, with ok set to false and an error message if the query could not be answered
+ */
+QueryResult QueryEngine::execute(const Query &query) const {
+    MemoryScope memoryScope(MemoryCategory::QUERIES);
+    QueryResult result;
+
+    if (query.type == QueryType::ROUTE) {
+        result.isRoute = true;
+        list<int> source, target;
+        if (!resolveLocation(query.source, source, result.error) ||
+            !resolveLocation(query.target, target, result.error)) {
+            result.ok = false;
+            return result;
+        }
+        airlineTable chosenAirlines;
+        for (const string &code: query.airlineCodes) {
+            const Airline *airline = dataRepository.findAirline(code);
+            if (airline == nullptr) {
+                result.ok = false;
+                result.error = "unknown airline " + code;
+                return result;
+            }
+            chosenAirlines.insert(*airline);
+        }
+        // Any airline: use the repository's table rather than copying every Airline on each query
+        const airlineTable &validAirlines = query.airlineCodes.empty() ? dataRepository.getAirlines() : chosenAirlines;
+
+        RouteKey key = RouteCache::makeKey(vector<int>(source.begin(), source.end()),
+                                           vector<int>(target.begin(), target.end()), validAirlines,
+                                           (int) query.criterion);
+        if (auto cached = routeCache.find(key, graph.getVersion())) {
+            result.paths = *cached;
+            return result;
+        }
+
+        if (query.criterion == RouteCriterion::AIRLINE_CHANGES)
+            result.paths = graph.getFewestChangesPath(source, target, validAirlines);
+        else if (query.criterion == RouteCriterion::PARETO)
+            result.paths = graph.getParetoPaths(source, target, validAirlines);
+        else result.paths = graph.getShortestPath(source, target, validAirlines);
+        if (!result.paths.empty() && result.paths.front().empty()) result.paths.clear();
+        routeCache.insert(key, graph.getVersion(), result.paths);
+        return result;
+    }
+
+    const Airport *airport = nullptr;
+    if (query.type <= QueryType::AIRPORT_ECCENTRICITY) {
+        airport = dataRepository.findAirport(query.airportCode);
+        if (airport == nullptr) {
+            result.ok = false;
+            result.error = "unknown airport " + query.airportCode;
+            return result;
+        }
+    }
+
+    switch (query.type) {
+        case QueryType::AIRPORT_FLIGHTS:
+            result.value = graph.numFlights(*airport);
+            break;
+        case QueryType::AIRPORT_AIRLINES:
+            result.value = graph.numAirlines(*airport);
+            break;
+        case QueryType::AIRPORT_DESTINATIONS:
+            result.value = graph.numDestinations(*airport);
+            break;
+        case QueryType::AIRPORT_COUNTRIES:
+            result.value = graph.numCountries(*airport);
+            break;
+        case QueryType::AIRPORTS_IN_X_FLIGHTS:
+            result.value = graph.numAirportsInXFlights(*airport, query.numFlights);
+            break;
+        case QueryType::CITIES_IN_X_FLIGHTS:
+            result.value = graph.numCitiesInXFlights(*airport, query.numFlights);
+            break;
+        case QueryType::COUNTRIES_IN_X_FLIGHTS:
+            result.value = graph.numCountriesInXFlights(*airport, query.numFlights);
+            break;
+        case QueryType::AIRPORT_ECCENTRICITY:
+            result.value = eccentricityCache.get(graph)->eccentricity[graph.findAirportNode(airport->getCode())];
+            break;
+        case QueryType::GLOBAL_FLIGHTS:
+            result.value = graph.getTotalFlights();
+            break;
+        case QueryType::GLOBAL_CONNECTIONS:
+            result.value = graph.getTotalFlightsAirlineless();
+            break;
+        case QueryType::GLOBAL_AIRPORTS:
+            result.value = (long long) dataRepository.getAirports().size();
+            break;
+        case QueryType::GLOBAL_AIRLINES:
+            result.value = (long long) dataRepository.getAirlines().size();
+            break;
+        case QueryType::GLOBAL_CITIES:
+            result.value = (long long) dataRepository.getNumCities();
+            break;
+        case QueryType::GLOBAL_COUNTRIES:
+            result.value = dataRepository.getTotalNumCountries();
+            break;
+        case QueryType::GLOBAL_SCCS:
+            result.value = graph.countSCCs();
+            break;
+        case QueryType::GLOBAL_DIAMETER:
+            result.value = eccentricityCache.get(graph)->diameter;
+            break;
+        case QueryType::GLOBAL_RADIUS:
+            result.value = eccentricityCache.get(graph)->radius;
+            break;
+        case QueryType::GLOBAL_CACHE_HITS:
+            result.value = (long long) routeCache.getHits();
+            break;
+        case QueryType::GLOBAL_CACHE_MISSES:
+            result.value = (long long) routeCache.getMisses();
+            break;
+        case QueryType::SEARCH:
+            result.isSearch = true;
+            result.matches = dataRepository.searchAirports(query.searchText, query.limit, query.maxEdits);
+            break;
+        case QueryType::ROUTE:
+            break;
+    }
+    return result;
+}
@@ -0,0 +1,35 @@
+#ifndef QUERYENGINE_H
+#define QUERYENGINE_H
+
+#include <optional>
+#include "query.h"
+#include "graph.h"
+#include "dataRepository.h"
+#include "routeCache.h"
+#include "eccentricityCache.h"
+
+class QueryEngine {
+private:
+    const Graph &graph;
+    const DataRepository &dataRepository;
+    mutable RouteCache routeCache;
+    mutable EccentricityCache eccentricityCache;
+
+    bool resolveLocation(const Location &location, std::list<int> &nodes, std::string &error) const;
+
+public:
+    size_t static const DEFAULT_CACHE_CAPACITY;
+
+    QueryEngine(const Graph &graph, const DataRepository &dataRepository,
+                size_t cacheCapacity = DEFAULT_CACHE_CAPACITY);
+
+    QueryResult execute(const Query &query) const;
+
+    const Graph &getGraph() const;
+
+    const DataRepository &getDataRepository() const;
+
+    const RouteCache &getRouteCache() const;
+};
+
+#endif
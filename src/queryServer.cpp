@@ -0,0 +1,266 @@
+#include "queryServer.h"
+#include "instrumentation.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+unsigned const QueryServer::MAX_PENDING_REQUESTS = 256;
+size_t const QueryServer::MAX_LINE_LENGTH = 1 << 16;
+
+/**
+ * Sets the O_NONBLOCK flag of a file descriptor
+ */
+static void setNonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+QueryServer::QueryServer(const QueryEngine &engine, unsigned numWorkers) : engine(engine),
+                                                                          formatter(OutputFormat::JSON_LINES),
+                                                                          pool(new ThreadPool(numWorkers)) {
+    if (pipe(wakeFds) == 0) {
+        setNonBlocking(wakeFds[0]);
+        setNonBlocking(wakeFds[1]);
+    }
+}
+
+/**
+ * Waits for the running queries, then closes every connection and the listening socket
+ */
+QueryServer::~QueryServer() {
+    pool.reset(); // Workers may still write to the wake pipe
+    while (!connections.empty()) closeConnection(connections.begin()->first);
+    if (listenFd != -1) close(listenFd);
+    if (!unixPath.empty()) unlink(unixPath.c_str());
+    for (int fd: wakeFds) if (fd != -1) close(fd);
+}
+
+/**
+ * Starts listening on a Unix domain socket, replacing any stale socket file at the given path
+ * @param path - Path of the socket file
+ * @param error - Reason the socket couldn't be created, if it couldn't
+ * @return true if the server is listening, false otherwise
+ */
+bool QueryServer::listenUnix(const string &path, string &error) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        error = "socket path too long";
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path.c_str());
+    unlink(path.c_str());
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd == -1 || bind(listenFd, (sockaddr *) &address, sizeof(address)) == -1 ||
+        listen(listenFd, SOMAXCONN) == -1) {
+        error = strerror(errno);
+        return false;
+    }
+    unixPath = path;
+    setNonBlocking(listenFd);
+    return true;
+}
+
+/**
+ * Starts listening on a TCP port of the loopback interface
+ * @param port - Port to listen on
+ * @param error - Reason the socket couldn't be created, if it couldn't
+ * @return true if the server is listening, false otherwise
+ */
+bool QueryServer::listenTcp(unsigned short port, string &error) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    if (listenFd == -1 || setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) == -1 ||
+        bind(listenFd, (sockaddr *) &address, sizeof(address)) == -1 || listen(listenFd, SOMAXCONN) == -1) {
+        error = strerror(errno);
+        return false;
+    }
+    setNonBlocking(listenFd);
+    return true;
+}
+
+/**
+ * Asks the event loop to stop. Only touches an atomic flag and the wake pipe, so it can be called from a signal handler
+ */
+void QueryServer::stop() {
+    stopRequested = true;
+    wake();
+}
+
+/**
+ * Wakes the event loop up from poll()
+ */
+void QueryServer::wake() {
+    char byte = 0;
+    [[maybe_unused]] ssize_t written = write(wakeFds[1], &byte, 1);
+}
+
+void QueryServer::closeConnection(unsigned long long id) {
+    close(connections.at(id).fd);
+    connections.erase(id);
+}
+
+/**
+ * Accepts every pending connection on the listening socket
+ */
+void QueryServer::acceptConnections() {
+    int fd;
+    while ((fd = accept(listenFd, nullptr, nullptr)) != -1) {
+        setNonBlocking(fd);
+        connections.emplace(nextConnectionId++, Connection{fd});
+    }
+}
+
+/**
+ * Reads the available bytes of a connection and hands every complete request line to the worker pool
+ * Lines holding "quit" close the connection once the previous responses are sent, and lines holding "metrics" are
+ * answered with the instrumentation measurements as JSON
+ * @param id - Identifier of the connection
+ * @param connection - Connection to read from
+ */
+void QueryServer::readFrom(unsigned long long id, Connection &connection) {
+    char chunk[1 << 14];
+    ssize_t received = recv(connection.fd, chunk, sizeof(chunk), 0);
+    if (received <= 0) {
+        if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) connection.closing = true;
+        return;
+    }
+    connection.readBuffer.append(chunk, received);
+
+    size_t start = 0, end;
+    while (!connection.closing && (end = connection.readBuffer.find('\n', start)) != string::npos) {
+        string line = connection.readBuffer.substr(start, end - start);
+        start = end + 1;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (QueryParser::isBlankOrComment(line)) continue;
+        if (line == "quit") {
+            connection.closing = true;
+            break;
+        }
+
+        unsigned sequence = connection.nextRequest++;
+        pool->submit([this, id, sequence, line = std::move(line)]() {
+            string response;
+            if (line == "metrics") response = Instrumentation::dumpJson() + '\n';
+            else {
+                Query query;
+                QueryResult result;
+                string error;
+                bool parsed;
+                {
+                    ScopedMeasurement measurement(Operation::QUERY_PARSE);
+                    parsed = QueryParser::parse(line, query, error);
+                }
+                if (parsed) {
+                    ScopedMeasurement measurement(Operation::QUERY_EXECUTE);
+                    result = engine.execute(query);
+                } else {
+                    result.ok = false;
+                    result.error = error;
+                }
+                ScopedMeasurement measurement(Operation::QUERY_FORMAT);
+                formatter.append(response, sequence, line, result);
+            }
+            {
+                lock_guard<mutex> lock(completedMutex);
+                completed.push_back({id, sequence, std::move(response)});
+            }
+            wake();
+        });
+    }
+    connection.readBuffer.erase(0, start);
+    if (connection.readBuffer.size() > MAX_LINE_LENGTH) connection.closing = true;
+}
+
+/**
+ * Sends as much of the pending responses of a connection as the socket accepts
+ * @param connection - Connection to write to
+ * @return false if the connection failed, true otherwise
+ */
+bool QueryServer::writeTo(Connection &connection) {
+    while (!connection.writeBuffer.empty()) {
+        ssize_t sent = send(connection.fd, connection.writeBuffer.data(), connection.writeBuffer.size(),
+                            MSG_NOSIGNAL);
+        if (sent == -1) return errno == EAGAIN || errno == EWOULDBLOCK;
+        connection.writeBuffer.erase(0, sent);
+    }
+    return true;
+}
+
+/**
+ * Moves the responses produced by the workers to their connections, keeping the order in which requests were received
+ */
+void QueryServer::collectCompleted() {
+    char drain[256];
+    while (read(wakeFds[0], drain, sizeof(drain)) > 0);
+
+    vector<Completion> batch;
+    {
+        lock_guard<mutex> lock(completedMutex);
+        batch.swap(completed);
+    }
+    for (Completion &completion: batch) {
+        auto it = connections.find(completion.connectionId);
+        if (it == connections.end()) continue; // The client left before the response was ready
+        Connection &connection = it->second;
+        connection.ready.emplace(completion.sequence, std::move(completion.response));
+        for (auto next = connection.ready.begin();
+             next != connection.ready.end() && next->first == connection.nextResponse;
+             next = connection.ready.erase(next), connection.nextResponse++) {
+            connection.writeBuffer += next->second;
+        }
+    }
+}
+
+/**
+ * Event loop: accepts connections, reads requests, and sends responses until stop() is called.
+ * Requests are executed by the worker pool against the shared, read-only graph; each connection gets its responses in request order
+ */
+void QueryServer::run() {
+    vector<pollfd> fds;
+    vector<unsigned long long> ids;
+
+    while (!stopRequested) {
+        fds.assign({{listenFd, POLLIN, 0}, {wakeFds[0], POLLIN, 0}});
+        ids.clear();
+        for (auto &[id, connection]: connections) {
+            short events = 0;
+            unsigned pending = connection.nextRequest - connection.nextResponse;
+            if (!connection.closing && pending < MAX_PENDING_REQUESTS) events |= POLLIN;
+            if (!connection.writeBuffer.empty()) events |= POLLOUT;
+            // Finished connections waiting on workers are left out, as their hang up would be reported on every poll
+            fds.push_back({events == 0 ? -1 : connection.fd, events, 0});
+            ids.push_back(id);
+        }
+
+        if (poll(fds.data(), fds.size(), -1) == -1) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (fds[1].revents & POLLIN) collectCompleted();
+        for (size_t i = 0; i < ids.size(); i++) {
+            Connection &connection = connections.at(ids[i]);
+            short revents = fds[i + 2].revents;
+            bool failed = (revents & (POLLERR | POLLNVAL)) != 0;
+            if (!failed && (revents & (POLLIN | POLLHUP))) readFrom(ids[i], connection);
+            if (!failed && !connection.writeBuffer.empty()) failed = !writeTo(connection);
+            bool finished = connection.closing && connection.nextRequest == connection.nextResponse &&
+                            connection.writeBuffer.empty();
+            if (failed || finished) closeConnection(ids[i]);
+        }
+        if (fds[0].revents & POLLIN) acceptConnections();
+    }
+}
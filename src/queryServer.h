@@ -0,0 +1,80 @@
+#ifndef QUERYSERVER_H
+#define QUERYSERVER_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "queryEngine.h"
+#include "resultFormatter.h"
+#include "threadPool.h"
+
+class QueryServer {
+private:
+    struct Connection {
+        int fd;
+        std::string readBuffer; // Received bytes not yet split into requests
+        std::string writeBuffer; // Responses waiting to be sent
+        unsigned nextRequest = 1; // Sequence number of the next request read from the connection
+        unsigned nextResponse = 1; // Sequence number of the next response to be sent
+        std::map<unsigned, std::string> ready; // Responses computed out of order, by sequence number
+        bool closing = false; // No more requests will be read from the connection
+
+        explicit Connection(int fd) : fd(fd) {}
+    };
+
+    struct Completion {
+        unsigned long long connectionId;
+        unsigned sequence;
+        std::string response;
+    };
+
+    const QueryEngine &engine;
+    ResultFormatter formatter;
+    int listenFd = -1;
+    int wakeFds[2] = {-1, -1}; // Pipe used by the workers and stop() to wake the event loop
+    std::string unixPath;
+    std::atomic<bool> stopRequested{false};
+    std::unordered_map<unsigned long long, Connection> connections;
+    unsigned long long nextConnectionId = 1;
+    std::mutex completedMutex;
+    std::vector<Completion> completed; // Responses produced by the workers, not yet handed to their connection
+    std::unique_ptr<ThreadPool> pool;
+
+    unsigned static const MAX_PENDING_REQUESTS;
+    size_t static const MAX_LINE_LENGTH;
+
+    void acceptConnections();
+
+    void readFrom(unsigned long long id, Connection &connection);
+
+    bool writeTo(Connection &connection);
+
+    void collectCompleted();
+
+    void wake();
+
+    void closeConnection(unsigned long long id);
+
+public:
+    QueryServer(const QueryEngine &engine, unsigned numWorkers);
+
+    ~QueryServer();
+
+    QueryServer(const QueryServer &) = delete;
+
+    QueryServer &operator=(const QueryServer &) = delete;
+
+    bool listenUnix(const std::string &path, std::string &error);
+
+    bool listenTcp(unsigned short port, std::string &error);
+
+    void run();
+
+    void stop();
+};
+
+#endif
@@ -0,0 +1,125 @@
+#include "resilienceAnalysis.h"
+#include <algorithm>
+#include "resultFormatter.h"
+
+using namespace std;
+
+/**
+ * Finds the articulation points (critical airports) and bridges (critical routes) of the undirected route network,
+ * where two airports are connected if there is a flight between them in either direction, with an iterative version
+ * of Tarjan's lowpoint algorithm. The subtree sizes of the DFS tree give how many airports each one would cut off.
+ * Time Complexity: O(|V| + |E| * log(d)), where d is the largest degree (sorting the neighbours of each node)
+ * @param graph - Graph to analyse
+ * @return The critical airports and routes, most critical first
+ */
+ResilienceReport ResilienceAnalysis::compute(const Graph &graph) {
+    int n = graph.getN();
+    const auto &nodes = graph.getNodes();
+
+    // Undirected neighbours of every node, without duplicates or self loops
+    vector<int> offsets(n + 2, 0), neighbours;
+    for (int u = 1; u <= n; u++) {
+        for (const auto &e: nodes[u].adj) {
+            if (e.dest == u) continue;
+            offsets[u + 1]++;
+            offsets[e.dest + 1]++;
+        }
+    }
+    for (int u = 1; u <= n; u++) offsets[u + 1] += offsets[u];
+    neighbours.resize(offsets[n + 1]);
+    vector<int> position(offsets.begin(), offsets.end() - 1);
+    for (int u = 1; u <= n; u++) {
+        for (const auto &e: nodes[u].adj) {
+            if (e.dest == u) continue;
+            neighbours[position[u]++] = e.dest;
+            neighbours[position[e.dest]++] = u;
+        }
+    }
+    vector<int> degree(n + 1, 0);
+    for (int u = 1; u <= n; u++) {
+        auto begin = neighbours.begin() + offsets[u], end = neighbours.begin() + offsets[u + 1];
+        sort(begin, end);
+        degree[u] = (int) (unique(begin, end) - begin);
+    }
+
+    ResilienceReport report;
+    vector<int> num(n + 1, -1), low(n + 1, 0), parent(n + 1, 0), next(n + 1, 0);
+    vector<unsigned> subtree(n + 1, 1), separatedSum(n + 1, 0), separatedMax(n + 1, 0), children(n + 1, 0);
+    vector<int> callStack, component;
+    int idx = 0;
+    for (int root = 1; root <= n; root++) {
+        if (num[root] != -1) continue;
+        component.clear();
+        size_t firstBridge = report.routes.size();
+        num[root] = low[root] = idx++;
+        callStack.push_back(root);
+        while (!callStack.empty()) {
+            int v = callStack.back();
+            if (next[v] < degree[v]) {
+                int w = neighbours[offsets[v] + next[v]++];
+                if (num[w] == -1) {
+                    parent[w] = v;
+                    num[w] = low[w] = idx++;
+                    children[v]++;
+                    callStack.push_back(w);
+                } else if (w != parent[v]) low[v] = min(low[v], num[w]);
+                continue;
+            }
+            callStack.pop_back();
+            component.push_back(v);
+            if (v == root) continue;
+            int p = parent[v];
+            low[p] = min(low[p], low[v]);
+            subtree[p] += subtree[v];
+            if (low[v] >= num[p]) { // Removing p separates v's subtree from the rest
+                separatedSum[p] += subtree[v];
+                separatedMax[p] = max(separatedMax[p], subtree[v]);
+            }
+            if (low[v] > num[p]) report.routes.push_back({p, v, subtree[v]});
+        }
+
+        unsigned componentSize = subtree[root];
+        for (int v: component) {
+            bool articulation = v == root ? children[v] >= 2 : separatedSum[v] > 0;
+            if (!articulation) continue;
+            unsigned rest = componentSize - 1 - separatedSum[v];
+            report.airports.push_back({v, componentSize - 1 - max(separatedMax[v], rest)});
+        }
+        for (size_t i = firstBridge; i < report.routes.size(); i++) {
+            report.routes[i].disconnected = min(report.routes[i].disconnected,
+                                                componentSize - report.routes[i].disconnected);
+        }
+    }
+
+    stable_sort(report.airports.begin(), report.airports.end(),
+                [](const CriticalAirport &a1, const CriticalAirport &a2) {
+                    return a1.disconnected > a2.disconnected;
+                });
+    stable_sort(report.routes.begin(), report.routes.end(),
+                [](const CriticalRoute &r1, const CriticalRoute &r2) { return r1.disconnected > r2.disconnected; });
+    return report;
+}
+
+/**
+ * Writes the critical airports and routes as CSV, with a header line. Airports have an empty second airport column.
+ * @param out - Stream to write to
+ * @param graph - Graph the report was computed from
+ * @param report - Critical airports and routes
+ */
+void ResilienceAnalysis::writeCsv(ostream &out, const Graph &graph, const ResilienceReport &report) {
+    const auto &nodes = graph.getNodes();
+    string text = "type,airport,airport2,disconnected\n";
+    for (const CriticalAirport &airport: report.airports) {
+        text += "airport,";
+        ResultFormatter::appendCsvField(text, nodes[airport.node].airport.getCode());
+        text += ",," + to_string(airport.disconnected) + '\n';
+    }
+    for (const CriticalRoute &route: report.routes) {
+        text += "route,";
+        ResultFormatter::appendCsvField(text, nodes[route.node1].airport.getCode());
+        text += ',';
+        ResultFormatter::appendCsvField(text, nodes[route.node2].airport.getCode());
+        text += ',' + to_string(route.disconnected) + '\n';
+    }
+    out << text;
+}
@@ -0,0 +1,30 @@
+#ifndef RESILIENCEANALYSIS_H
+#define RESILIENCEANALYSIS_H
+
+#include <ostream>
+#include <vector>
+#include "graph.h"
+
+struct CriticalAirport {
+    int node; // Node of the articulation point
+    unsigned disconnected; // Airports cut off from the largest remaining part of its component if it is removed
+};
+
+struct CriticalRoute {
+    int node1, node2; // Nodes connected by the bridge
+    unsigned disconnected; // Airports on the smaller side of the bridge
+};
+
+struct ResilienceReport {
+    std::vector<CriticalAirport> airports; // Sorted by disconnected airports, most critical first
+    std::vector<CriticalRoute> routes; // Sorted by disconnected airports, most critical first
+};
+
+class ResilienceAnalysis {
+public:
+    static ResilienceReport compute(const Graph &graph);
+
+    static void writeCsv(std::ostream &out, const Graph &graph, const ResilienceReport &report);
+};
+
+#endif
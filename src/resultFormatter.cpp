@@ -0,0 +1,217 @@
+#include "resultFormatter.h"
+#include <algorithm>
+
+using namespace std;
+
+ResultFormatter::ResultFormatter(OutputFormat format) : format(format) {}
+
+/**
+ * Converts the name of an output format ("csv" or "jsonl") to the corresponding OutputFormat
+ * @param name - Name of the format
+ * @param format - OutputFormat to fill in
+ * @return true if the name is a known format, false otherwise
+ */
+bool ResultFormatter::parseFormat(const string &name, OutputFormat &format) {
+    if (name == "csv") format = OutputFormat::CSV;
+    else if (name == "jsonl") format = OutputFormat::JSON_LINES;
+    else return false;
+    return true;
+}
+
+/**
+ * Returns the codes of the given airlines in alphabetical order, so results are printed deterministically
+ * Time Complexity: O(n log n), where n is the size of airlines
+ */
+vector<string> ResultFormatter::sortedCodes(const airlineTable &airlines) {
+    vector<string> codes;
+    codes.reserve(airlines.size());
+    for (const Airline &airline: airlines) codes.push_back(airline.getCode());
+    sort(codes.begin(), codes.end());
+    return codes;
+}
+
+/**
+ * Appends a field to a CSV line, quoting it if it contains separators, quotes or line breaks
+ */
+void ResultFormatter::appendCsvField(string &out, const string &field) {
+    if (field.find_first_of(",\"\n\r") == string::npos) {
+        out += field;
+        return;
+    }
+    out += '"';
+    for (char c: field) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+/**
+ * Appends a quoted and escaped JSON string
+ */
+void ResultFormatter::appendJsonString(string &out, const string &text) {
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    for (char c: text) {
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if ((unsigned char) c < 0x20) {
+                    out += "\\u00";
+                    out += hex[(c >> 4) & 0xF];
+                    out += hex[c & 0xF];
+                } else out += c;
+        }
+    }
+    out += '"';
+}
+
+/**
+ * Converts the paths of a route result to text, in the same notation used by the flights menu, separating paths with " | "
+ * Time Complexity: O(n), where n is the total number of flights in the paths
+ * @param result - Result of a route query
+ * @return Text representation of the paths
+ */
+string ResultFormatter::pathsToText(const QueryResult &result) {
+    string text;
+    for (const auto &path: result.paths) {
+        if (!text.empty()) text += " | ";
+        bool first = true;
+        for (const pair<airlineTable, string> &flights: path) {
+            if (!first) text += " -> ";
+            first = false;
+            text += flights.second;
+            if (flights.first.empty()) continue;
+            text += " (flights by:";
+            for (const string &code: sortedCodes(flights.first)) text += " " + code;
+            text += ")";
+        }
+    }
+    return text;
+}
+
+/**
+ * Converts the matches of a search result to text, each as "CODE (name, city, country)", separated by " | "
+ * Time Complexity: O(n), where n is the number of matches
+ * @param result - Result of a search query
+ * @return Text representation of the matches
+ */
+string ResultFormatter::matchesToText(const QueryResult &result) {
+    string text;
+    for (const AirportMatch &match: result.matches) {
+        if (!text.empty()) text += " | ";
+        const Airport &airport = *match.airport;
+        text += airport.getCode() + " (" + airport.getName() + ", " + airport.getCity() + ", " + airport.getCountry() +
+                ")";
+    }
+    return text;
+}
+
+/**
+ * Appends the header line of the output, if the format has one
+ * @param out - Buffer to append to
+ */
+void ResultFormatter::appendHeader(string &out) const {
+    if (format == OutputFormat::CSV) out += "line,query,status,result\n";
+}
+
+/**
+ * Appends the formatted result of a query to the output buffer
+ * Time Complexity: O(n), where n is the size of the result
+ * @param out - Buffer to append to
+ * @param lineNumber - Line of the input the query was read from
+ * @param queryText - Text of the query
+ * @param result - Result of the query
+ */
+void ResultFormatter::append(string &out, unsigned lineNumber, const string &queryText,
+                             const QueryResult &result) const {
+    if (format == OutputFormat::CSV) {
+        out += to_string(lineNumber);
+        out += ',';
+        appendCsvField(out, queryText);
+        out += result.ok ? ",ok," : ",error,";
+        if (!result.ok) appendCsvField(out, result.error);
+        else if (result.isRoute) appendCsvField(out, pathsToText(result));
+        else if (result.isSearch) appendCsvField(out, matchesToText(result));
+        else out += to_string(result.value);
+        out += '\n';
+        return;
+    }
+
+    out += "{\"line\":";
+    out += to_string(lineNumber);
+    out += ",\"query\":";
+    appendJsonString(out, queryText);
+    if (!result.ok) {
+        out += ",\"status\":\"error\",\"error\":";
+        appendJsonString(out, result.error);
+    } else if (result.isRoute) {
+        out += ",\"status\":\"ok\",\"paths\":[";
+        bool firstPath = true;
+        for (const auto &path: result.paths) {
+            if (!firstPath) out += ',';
+            firstPath = false;
+            out += '[';
+            bool firstStop = true;
+            for (const pair<airlineTable, string> &flights: path) {
+                if (!firstStop) out += ',';
+                firstStop = false;
+                out += "{\"airport\":";
+                appendJsonString(out, flights.second);
+                if (!flights.first.empty()) {
+                    out += ",\"airlines\":[";
+                    bool firstAirline = true;
+                    for (const string &code: sortedCodes(flights.first)) {
+                        if (!firstAirline) out += ',';
+                        firstAirline = false;
+                        appendJsonString(out, code);
+                    }
+                    out += ']';
+                }
+                out += '}';
+            }
+            out += ']';
+        }
+        out += ']';
+    } else if (result.isSearch) {
+        static const char *fields[] = {"code", "name", "city"};
+        out += ",\"status\":\"ok\",\"matches\":[";
+        bool first = true;
+        for (const AirportMatch &match: result.matches) {
+            if (!first) out += ',';
+            first = false;
+            out += "{\"code\":";
+            appendJsonString(out, match.airport->getCode());
+            out += ",\"name\":";
+            appendJsonString(out, match.airport->getName());
+            out += ",\"city\":";
+            appendJsonString(out, match.airport->getCity());
+            out += ",\"country\":";
+            appendJsonString(out, match.airport->getCountry());
+            out += ",\"field\":\"";
+            out += fields[(int) match.field];
+            out += "\",\"edits\":";
+            out += to_string(match.edits);
+            out += '}';
+        }
+        out += ']';
+    } else {
+        out += ",\"status\":\"ok\",\"value\":";
+        out += to_string(result.value);
+    }
+    out += "}\n";
+}
@@ -0,0 +1,36 @@
+#ifndef RESULTFORMATTER_H
+#define RESULTFORMATTER_H
+
+#include <string>
+#include "query.h"
+
+enum class OutputFormat {
+    CSV,
+    JSON_LINES
+};
+
+class ResultFormatter {
+private:
+    OutputFormat format;
+
+    static void appendJsonString(std::string &out, const std::string &text);
+
+    static std::vector<std::string> sortedCodes(const airlineTable &airlines);
+
+public:
+    explicit ResultFormatter(OutputFormat format);
+
+    static bool parseFormat(const std::string &name, OutputFormat &format);
+
+    static void appendCsvField(std::string &out, const std::string &field);
+
+    void appendHeader(std::string &out) const;
+
+    void append(std::string &out, unsigned lineNumber, const std::string &queryText, const QueryResult &result) const;
+
+    static std::string pathsToText(const QueryResult &result);
+
+    static std::string matchesToText(const QueryResult &result);
+};
+
+#endif
@@ -0,0 +1,140 @@
+#include "routeCache.h"
+#include <algorithm>
+
+using namespace std;
+
+bool RouteKey::operator==(const RouteKey &other) const {
+    return numAirlines == other.numAirlines && criterion == other.criterion && airlinesFingerprint[0] == other.airlinesFingerprint[0] &&
+           airlinesFingerprint[1] == other.airlinesFingerprint[1] && source == other.source && target == other.target;
+}
+
+size_t RouteKeyHash::operator()(const RouteKey &key) const {
+    size_t h = key.airlinesFingerprint[0] * 31 + key.criterion;
+    for (int v: key.source) h = h * 31 + v;
+    h = h * 1000003 + key.target.size();
+    for (int v: key.target) h = h * 31 + v;
+    return h;
+}
+
+/**
+ * Creates a cache holding at most capacity routes
+ * @param capacity - Max number of cached routes, 0 disabling the cache
+ */
+RouteCache::RouteCache(size_t capacity) : capacity(capacity) {}
+
+/**
+ * Builds the normalised key of a route query, so queries differing only in the order of their airports or airlines share an entry
+ * Time Complexity: O(s log s + t log t + a log a), where s, t and a are the number of sources, targets and valid airlines
+ * @param source - Indexes of the source nodes
+ * @param target - Indexes of the target nodes
+ * @param validAirlines - unordered_set of Airlines that are valid
+ * @param criterion - RouteCriterion the routes minimise
+ * @return Key of the query
+ */
+RouteKey RouteCache::makeKey(vector<int> source, vector<int> target, const airlineTable &validAirlines,
+                             int criterion) {
+    sort(source.begin(), source.end());
+    sort(target.begin(), target.end());
+
+    vector<const string *> codes;
+    codes.reserve(validAirlines.size());
+    for (const Airline &airline: validAirlines) codes.push_back(&airline.getCode());
+    sort(codes.begin(), codes.end(), [](const string *a, const string *b) { return *a < *b; });
+
+    // FNV-1a and a multiplicative hash over the sorted codes, separated by a byte that can't appear in a code
+    unsigned long long fnv = 14695981039346656037ULL, mult = 0;
+    auto mix = [&fnv, &mult](unsigned char c) {
+        fnv = (fnv ^ c) * 1099511628211ULL;
+        mult = mult * 0x9E3779B97F4A7C15ULL + c + 1;
+    };
+    for (const string *code: codes) {
+        for (char c: *code) mix((unsigned char) c);
+        mix('\0');
+    }
+    return {std::move(source), std::move(target), {fnv, mult}, codes.size(), criterion};
+}
+
+/**
+ * Drops every cached route if they were computed on a different version of the graph. Must be called with the mutex held
+ * @param currentGraphVersion - Current version of the graph
+ */
+void RouteCache::invalidateIfStale(unsigned long long currentGraphVersion) {
+    if (currentGraphVersion == graphVersion) return;
+    entries.clear();
+    index.clear();
+    graphVersion = currentGraphVersion;
+}
+
+/**
+ * Finds the cached routes of a query, marking them as the most recently used
+ * Time Complexity: O(k) (average case), where k is the size of the key
+ * @param key - Key of the query
+ * @param currentGraphVersion - Current version of the graph
+ * @return The cached routes, or nullptr if the query isn't cached
+ */
+shared_ptr<const routeList> RouteCache::find(const RouteKey &key, unsigned long long currentGraphVersion) {
+    lock_guard<std::mutex> lock(mutex);
+    invalidateIfStale(currentGraphVersion);
+    auto it = index.find(key);
+    if (it == index.end()) {
+        misses++;
+        return nullptr;
+    }
+    hits++;
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->second;
+}
+
+/**
+ * Caches the routes of a query, evicting the least recently used entry if the cache is full
+ * Time Complexity: O(k) (average case), where k is the size of the key
+ * @param key - Key of the query
+ * @param currentGraphVersion - Version of the graph the routes were computed on
+ * @param routes - Routes to cache
+ */
+void RouteCache::insert(const RouteKey &key, unsigned long long currentGraphVersion, routeList routes) {
+    if (capacity == 0) return;
+    auto value = make_shared<const routeList>(std::move(routes));
+    lock_guard<std::mutex> lock(mutex);
+    invalidateIfStale(currentGraphVersion);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        it->second->second = value;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+    if (entries.size() >= capacity) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+    entries.emplace_front(key, value);
+    index.emplace(key, entries.begin());
+}
+
+/**
+ * Drops every cached route
+ */
+void RouteCache::invalidate() {
+    lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+}
+
+size_t RouteCache::getCapacity() const {
+    return capacity;
+}
+
+size_t RouteCache::size() const {
+    lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+unsigned long long RouteCache::getHits() const {
+    lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+unsigned long long RouteCache::getMisses() const {
+    lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
@@ -0,0 +1,63 @@
+#ifndef ROUTECACHE_H
+#define ROUTECACHE_H
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "airline.h"
+
+typedef std::list<std::list<std::pair<airlineTable, std::string>>> routeList;
+
+struct RouteKey {
+    std::vector<int> source; // Sorted source node indexes
+    std::vector<int> target; // Sorted target node indexes
+    unsigned long long airlinesFingerprint[2]; // Two independent hashes of the sorted valid airline codes
+    size_t numAirlines;
+    int criterion; // RouteCriterion the routes minimise
+
+    bool operator==(const RouteKey &other) const;
+};
+
+struct RouteKeyHash {
+    std::size_t operator()(const RouteKey &key) const;
+};
+
+class RouteCache {
+private:
+    typedef std::pair<RouteKey, std::shared_ptr<const routeList>> entry;
+
+    size_t capacity;
+    std::list<entry> entries; // Most recently used first
+    std::unordered_map<RouteKey, std::list<entry>::iterator, RouteKeyHash> index;
+    unsigned long long graphVersion = 0; // Version of the graph the cached routes were computed on
+    unsigned long long hits = 0;
+    unsigned long long misses = 0;
+    mutable std::mutex mutex;
+
+    void invalidateIfStale(unsigned long long currentGraphVersion);
+
+public:
+    explicit RouteCache(size_t capacity);
+
+    static RouteKey makeKey(std::vector<int> source, std::vector<int> target, const airlineTable &validAirlines,
+                            int criterion = 0);
+
+    std::shared_ptr<const routeList> find(const RouteKey &key, unsigned long long currentGraphVersion);
+
+    void insert(const RouteKey &key, unsigned long long currentGraphVersion, routeList routes);
+
+    void invalidate();
+
+    size_t getCapacity() const;
+
+    size_t size() const;
+
+    unsigned long long getHits() const;
+
+    unsigned long long getMisses() const;
+};
+
+#endif
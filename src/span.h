@@ -0,0 +1,32 @@
+#ifndef SPAN_H
+#define SPAN_H
+
+#include <cstddef>
+
+/**
+ * Read-only view of a contiguous range of elements owned by another structure, valid while that structure isn't
+ * changed (std::span is C++20)
+ */
+template<typename T>
+class Span {
+private:
+    const T *first = nullptr;
+    const T *last = nullptr;
+
+public:
+    Span() = default;
+
+    Span(const T *first, const T *last) : first(first), last(last) {}
+
+    const T *begin() const { return first; }
+
+    const T *end() const { return last; }
+
+    size_t size() const { return last - first; }
+
+    bool empty() const { return first == last; }
+
+    const T &operator[](size_t i) const { return first[i]; }
+};
+
+#endif
@@ -0,0 +1,90 @@
+#include "threadPool.h"
+#include <atomic>
+
+using namespace std;
+
+/**
+ * Starts the worker threads
+ * @param numThreads - Number of worker threads, or 0 for one per hardware thread
+ */
+ThreadPool::ThreadPool(unsigned numThreads) {
+    if (numThreads == 0) numThreads = defaultThreads();
+    workers.reserve(numThreads);
+    for (unsigned i = 0; i < numThreads; i++) workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+/**
+ * Finishes the tasks already submitted and joins the worker threads
+ */
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(tasksMutex);
+        stopping = true;
+    }
+    available.notify_all();
+    for (thread &worker: workers) worker.join();
+}
+
+/**
+ * Returns the number of hardware threads, or 1 if it can't be determined
+ */
+unsigned ThreadPool::defaultThreads() {
+    unsigned hardwareThreads = thread::hardware_concurrency();
+    return hardwareThreads == 0 ? 1 : hardwareThreads;
+}
+
+unsigned ThreadPool::size() const {
+    return workers.size();
+}
+
+/**
+ * Queues a task to be executed by one of the worker threads
+ * @param task - Task to execute
+ */
+void ThreadPool::submit(function<void()> task) {
+    {
+        lock_guard<mutex> lock(tasksMutex);
+        tasks.push(std::move(task));
+    }
+    available.notify_one();
+}
+
+/**
+ * Calls body for every item in [0, count) using all the worker threads, and waits until every call returned.
+ * Each worker claims items one at a time, so uneven items are balanced. Must not be called from a task of this pool.
+ * @param count - Number of items
+ * @param body - Function called with the item and the slot of the calling worker, in [0, size()), which callers can
+ * use to index per-worker scratch space
+ */
+void ThreadPool::parallelFor(unsigned count, const function<void(unsigned item, unsigned slot)> &body) {
+    atomic<unsigned> nextItem{0};
+    unsigned running = size();
+    mutex doneMutex;
+    condition_variable done;
+    for (unsigned slot = 0; slot < size(); slot++) {
+        submit([&, slot] {
+            for (unsigned item = nextItem++; item < count; item = nextItem++) body(item, slot);
+            lock_guard<mutex> lock(doneMutex);
+            if (--running == 0) done.notify_one();
+        });
+    }
+    unique_lock<mutex> lock(doneMutex);
+    done.wait(lock, [&running] { return running == 0; });
+}
+
+/**
+ * Executes queued tasks until the pool is stopped and no tasks are left
+ */
+void ThreadPool::workerLoop() {
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<mutex> lock(tasksMutex);
+            available.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex tasksMutex;
+    std::condition_variable available;
+    bool stopping = false;
+
+    void workerLoop();
+
+public:
+    explicit ThreadPool(unsigned numThreads = 0);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    void submit(std::function<void()> task);
+
+    void parallelFor(unsigned count, const std::function<void(unsigned item, unsigned slot)> &body);
+
+    unsigned size() const;
+
+    static unsigned defaultThreads();
+};
+
+#endif
@@ -0,0 +1,70 @@
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include "networkGenerator.h"
+
+using namespace std;
+
+/**
+ * Outputs the accepted command line options
+ */
+void printUsage(const char *program) {
+    GeneratorOptions defaults;
+    cerr << "Usage: " << program << " --output DIR [options]" << endl
+         << "  --airports N             number of airports (" << defaults.numAirports << ")" << endl
+         << "  --airlines N             number of airlines (" << defaults.numAirlines << ")" << endl
+         << "  --clusters N             number of geographic clusters/countries (" << defaults.numClusters << ")"
+         << endl
+         << "  --routes-per-airport X   average destinations per airport (" << defaults.routesPerAirport << ")" << endl
+         << "  --airlines-per-route N   max airlines flying each route (" << defaults.maxAirlinesPerRoute << ")"
+         << endl
+         << "  --hub-exponent X         Zipf exponent of airport sizes (" << defaults.hubExponent << ")" << endl
+         << "  --local-fraction X       share of routes inside their cluster (" << defaults.localFraction << ")"
+         << endl
+         << "  --cluster-spread X       airport spread around the cluster centre, in degrees ("
+         << defaults.clusterSpread << ")" << endl
+         << "  --return-probability X   probability of a route being flown both ways ("
+         << defaults.returnProbability << ")" << endl
+         << "  --seed N                 random seed (" << defaults.seed << ")" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    GeneratorOptions options;
+    string output;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        const char *option = argv[i], *value = argv[++i];
+        if (!strcmp(option, "--output")) output = value;
+        else if (!strcmp(option, "--airports")) options.numAirports = strtoul(value, nullptr, 10);
+        else if (!strcmp(option, "--airlines")) options.numAirlines = strtoul(value, nullptr, 10);
+        else if (!strcmp(option, "--clusters")) options.numClusters = strtoul(value, nullptr, 10);
+        else if (!strcmp(option, "--routes-per-airport")) options.routesPerAirport = strtod(value, nullptr);
+        else if (!strcmp(option, "--airlines-per-route")) options.maxAirlinesPerRoute = strtoul(value, nullptr, 10);
+        else if (!strcmp(option, "--hub-exponent")) options.hubExponent = strtod(value, nullptr);
+        else if (!strcmp(option, "--local-fraction")) options.localFraction = strtod(value, nullptr);
+        else if (!strcmp(option, "--cluster-spread")) options.clusterSpread = strtod(value, nullptr);
+        else if (!strcmp(option, "--return-probability")) options.returnProbability = strtod(value, nullptr);
+        else if (!strcmp(option, "--seed")) options.seed = strtoull(value, nullptr, 10);
+        else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (output.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    error_code fsError;
+    filesystem::create_directories(output, fsError);
+    string error;
+    if (fsError || !NetworkGenerator(options).writeDataset(output, error)) {
+        cerr << (fsError ? fsError.message() : error) << endl;
+        return 1;
+    }
+    return 0;
+}